@@ -7,11 +7,20 @@
 * @date 3/24/2008
 */
 
+#include <climits>
 #include "BTreeIndex.h"
 #include "BTreeNode.h"
 
 using namespace std;
 
+//the header page stores rootPid, treeHeight, lastLeafPid and maxKey,
+//followed by STATS_MAGIC, entryCount, minKey and leafCount, and then
+//LAST_LEAF_MAGIC. an index written without the statistics lacks the first
+//magic number. an index written before the rightmost leaf was kept lacks
+//the second one, and holds garbage in place of lastLeafPid and maxKey
+static const int STATS_MAGIC = 0x42545331; //"BTS1"
+static const int LAST_LEAF_MAGIC = 0x42544c31; //"BTL1"
+
 /*
 * BTreeIndex constructor
 */
@@ -19,6 +28,13 @@ BTreeIndex::BTreeIndex()
 {
 	treeHeight = 0;
 	rootPid = -1;
+	lastLeafPid = -1;
+	maxKey = INT_MIN;
+	minKey = INT_MAX;
+	entryCount = 0;
+	leafCount = 0;
+	statsValid = true;
+	readOnly = false;
 	currentPage = -1;
 	currentReadNode = new BTLeafNode();
 }
@@ -33,28 +49,76 @@ BTreeIndex::BTreeIndex()
 RC BTreeIndex::open(const string& indexname, char mode)
 {
 	if (pf.open(indexname, mode) != 0) return RC_FILE_OPEN_FAILED;
+	readOnly = (mode == 'r' || mode == 'R');
 	char buffer[PageFile::PAGE_SIZE];
 	if (pf.endPid() == 0)
 	{
+		//an empty file opened for reading has no header to read
+		if (readOnly)
+		{
+			pf.close();
+			return RC_INVALID_FILE_FORMAT;
+		}
+		//a new index starts with the statistics of an empty tree
+		minKey = INT_MAX;
+		entryCount = 0;
+		leafCount = 0;
+		statsValid = true;
 		close();
 		return open(indexname, mode);
 	}
 	if (pf.read(0, buffer) != 0) return RC_FILE_READ_FAILED;
 	memcpy(&rootPid, buffer, sizeof(PageId));
 	memcpy(&treeHeight, buffer + sizeof(PageId), sizeof(int));
+	memcpy(&lastLeafPid, buffer + sizeof(PageId) + sizeof(int), sizeof(PageId));
+	memcpy(&maxKey, buffer + 2 * sizeof(PageId) + sizeof(int), sizeof(int));
+	int magic, leafMagic;
+	memcpy(&magic, buffer + 2 * sizeof(PageId) + 2 * sizeof(int), sizeof(int));
+	memcpy(&entryCount, buffer + 2 * sizeof(PageId) + 3 * sizeof(int), sizeof(int));
+	memcpy(&minKey, buffer + 2 * sizeof(PageId) + 4 * sizeof(int), sizeof(int));
+	memcpy(&leafCount, buffer + 2 * sizeof(PageId) + 5 * sizeof(int), sizeof(int));
+	memcpy(&leafMagic, buffer + 2 * sizeof(PageId) + 6 * sizeof(int), sizeof(int));
+	//the statistics include the largest key
+	statsValid = (magic == STATS_MAGIC && leafMagic == LAST_LEAF_MAGIC);
+	//an index written without the rightmost leaf information cannot use the
+	//fast path, and never will, since its largest key is unknown
+	if (leafMagic != LAST_LEAF_MAGIC || lastLeafPid <= 0 || lastLeafPid >= pf.endPid())
+	{
+		lastLeafPid = -1;
+		if (leafMagic != LAST_LEAF_MAGIC) maxKey = INT_MIN;
+	}
 	return 0;
 }
 
 /*
 * Close the index file.
+* The header is written back unless the index was opened in 'r' mode.
 * @return error code. 0 if no error
 */
 RC BTreeIndex::close()
 {
+	if (readOnly) return pf.close();
 	char buffer[PageFile::PAGE_SIZE];
+	memset(buffer, 0, PageFile::PAGE_SIZE);
 	memcpy(buffer, &rootPid, sizeof(PageId));
 	memcpy(buffer + sizeof(PageId), &treeHeight, sizeof(int));
-	if (pf.write(0, buffer) != 0) return RC_FILE_WRITE_FAILED;
+	memcpy(buffer + sizeof(PageId) + sizeof(int), &lastLeafPid, sizeof(PageId));
+	memcpy(buffer + 2 * sizeof(PageId) + sizeof(int), &maxKey, sizeof(int));
+	memcpy(buffer + 2 * sizeof(PageId) + 6 * sizeof(int), &LAST_LEAF_MAGIC, sizeof(int));
+	//the statistics of an index that did not keep them from the start are not written
+	if (statsValid)
+	{
+		memcpy(buffer + 2 * sizeof(PageId) + 2 * sizeof(int), &STATS_MAGIC, sizeof(int));
+		memcpy(buffer + 2 * sizeof(PageId) + 3 * sizeof(int), &entryCount, sizeof(int));
+		memcpy(buffer + 2 * sizeof(PageId) + 4 * sizeof(int), &minKey, sizeof(int));
+		memcpy(buffer + 2 * sizeof(PageId) + 5 * sizeof(int), &leafCount, sizeof(int));
+	}
+	//the file is closed even if the header cannot be written
+	if (pf.write(0, buffer) != 0)
+	{
+		pf.close();
+		return RC_FILE_WRITE_FAILED;
+	}
 	return pf.close();
 }
 
@@ -86,16 +150,20 @@ RC BTreeIndex::insertHelp(int key, const RecordId& rid, int currentHeight, PageI
 			BTLeafNode sibling = BTLeafNode();
 			//insert and split
 			if (leaf->insertAndSplit(key, rid, sibling, siblingKey)) return RC_FILE_WRITE_FAILED;
-			//assign the page id to the sibling 
-			siblingPid = pf.endPid();
+			//assign a free page, or a new page at the end of the file, to the sibling
+			if (pf.allocPage(siblingPid)) return RC_FILE_WRITE_FAILED;
 			//assign the next pointer of current node to the next pointer of sibling node
 			if (sibling.setNextNodePtr(leaf->getNextNodePtr())) return RC_FILE_WRITE_FAILED;
 			//change the next pointer of the current node to the sibling node pid
 			if (leaf->setNextNodePtr(siblingPid)) return RC_FILE_WRITE_FAILED;
+			//the sibling of the rightmost leaf becomes the new rightmost leaf,
+			//unless the rightmost leaf is not kept (see open())
+			if (sibling.getNextNodePtr() == 0 && lastLeafPid > 0) lastLeafPid = siblingPid;
 			//write the modified current node to the page file
 			if (leaf->write(currentPid, pf)) return RC_FILE_WRITE_FAILED;
 			//write the new sibling node to the page file
 			if (sibling.write(siblingPid, pf)) return RC_FILE_WRITE_FAILED;
+			leafCount++;
 			return RC_LEAFNODE_OVERFLOW;  //need to be tackle with on the upper level tree
 		}
 	}
@@ -132,7 +200,7 @@ RC BTreeIndex::insertHelp(int key, const RecordId& rid, int currentHeight, PageI
 				if (nonleaf->insertAndSplit(siblingKey, siblingPid, sibling, nonLeafSiblingKey)) return RC_FILE_WRITE_FAILED;
 				//siblingkey to be insert into upper level tree comes to be nonLeafSiblingKey
 				siblingKey = nonLeafSiblingKey;
-				siblingPid = pf.endPid();
+				if (pf.allocPage(siblingPid)) return RC_FILE_WRITE_FAILED;
 				//write the modified current node to the page file
 				if (nonleaf->write(currentPid, pf)) return RC_FILE_WRITE_FAILED;
 				//write the modified sibling node to the page file
@@ -152,6 +220,23 @@ RC BTreeIndex::insertHelp(int key, const RecordId& rid, int currentHeight, PageI
 */
 RC BTreeIndex::insert(int key, const RecordId& rid)
 {
+	entryCount++;
+	if (key < minKey) minKey = key;
+	// if the key exceeds the current max, it goes to the end of the rightmost leaf.
+	// append it there directly without descending from the root, unless the leaf is full
+	if (lastLeafPid > 0 && key > maxKey)
+	{
+		BTLeafNode leaf;
+		if (leaf.read(lastLeafPid, pf)) return RC_FILE_READ_FAILED;
+		if (leaf.getKeyCount() < 80)
+		{
+			if (leaf.insert(key, rid)) return RC_FILE_WRITE_FAILED;
+			if (leaf.write(lastLeafPid, pf)) return RC_FILE_WRITE_FAILED;
+			maxKey = key;
+			return 0; //success
+		}
+	}
+	if (key > maxKey) maxKey = key;
 	// if the tree is empty, create one
 	if (treeHeight == 0)
 	{
@@ -159,9 +244,12 @@ RC BTreeIndex::insert(int key, const RecordId& rid)
 		BTLeafNode *leaf = new BTLeafNode();
 		//insert the key-rid pair directly, since we are sure that node is empty
 		if (leaf->insert(key, rid)) return RC_FILE_WRITE_FAILED;
-		rootPid = pf.endPid();
+		if (pf.allocPage(rootPid)) return RC_FILE_WRITE_FAILED;
 		//write the new leaf node to the page file
 		if (leaf->write(rootPid, pf)) return RC_FILE_WRITE_FAILED;
+		//the only leaf is also the rightmost one
+		lastLeafPid = rootPid;
+		leafCount = 1;
 		//increase the height by one
 		treeHeight++;
 		return 0; //success
@@ -178,7 +266,7 @@ RC BTreeIndex::insert(int key, const RecordId& rid)
 			//create and initialize the root node
 			BTNonLeafNode *root = new BTNonLeafNode();
 			if (root->initializeRoot(rootPid, siblingKey, siblingPid)) return RC_FILE_WRITE_FAILED;
-			rootPid = pf.endPid();
+			if (pf.allocPage(rootPid)) return RC_FILE_WRITE_FAILED;
 			//write the new root to the page file
 			if (root->write(rootPid, pf)) return RC_FILE_WRITE_FAILED;
 			//increase the height by one
@@ -189,6 +277,240 @@ RC BTreeIndex::insert(int key, const RecordId& rid)
 	}
 }
 
+/*
+* Descend from the root to the leaf node for the key, remembering the
+* non-leaf nodes on the way and the child taken in each of them.
+* @param key[IN] the key to look up
+* @param path[OUT] the PageIds of the non-leaf nodes from the root down
+* @param index[OUT] the child number taken in every node of path
+* @param leafPid[OUT] the PageId of the leaf node
+* @return error code. 0 if no error
+*/
+RC BTreeIndex::findPath(int key, vector<PageId>& path, vector<int>& index, PageId& leafPid)
+{
+	BTNonLeafNode nonleaf;
+	PageId pid = rootPid;
+	path.clear();
+	index.clear();
+	for (int i = 0; i < treeHeight - 1; i++)
+	{
+		if (nonleaf.read(pid, pf)) return RC_FILE_READ_FAILED;
+		PageId child;
+		if (nonleaf.locateChildPtr(key, child)) return RC_FILE_SEEK_FAILED;
+		//find the number of the child to remember it
+		int n = 0;
+		PageId temp;
+		while (n <= nonleaf.getKeyCount() && nonleaf.readChildPtr(n, temp) == 0 && temp != child) n++;
+		path.push_back(pid);
+		index.push_back(n);
+		pid = child;
+	}
+	leafPid = pid;
+	return 0;
+}
+
+/*
+* Take an empty leaf node out of the tree and free its page.
+* The leaf is unlinked from the leaf before it, its pointer is removed
+* from the parent, and a parent left without children is removed in turn.
+* A root left with a single child is replaced by the child.
+* @param path[IN] the non-leaf nodes from the root down to the leaf
+* @param index[IN] the child number taken in every node of path
+* @param leafPid[IN] the PageId of the empty leaf node
+* @param nextPid[IN] the PageId of the leaf node after it
+* @return error code. 0 if no error
+*/
+RC BTreeIndex::unlinkLeaf(const vector<PageId>& path, const vector<int>& index, PageId leafPid, PageId nextPid)
+{
+	BTNonLeafNode nonleaf;
+	BTLeafNode leaf;
+	//the leaf before is the rightmost leaf under the child before the path,
+	//at the lowest level where the path does not take the first child.
+	//a node split off by insertAndSplit() starts with an unused null
+	//pointer, which does not count as a child
+	PageId prevPid = -1;
+	for (int level = path.size() - 1; level >= 0; level--)
+	{
+		if (index[level] == 0) continue;
+		if (nonleaf.read(path[level], pf)) return RC_FILE_READ_FAILED;
+		if (nonleaf.readChildPtr(index[level] - 1, prevPid)) return RC_INVALID_CURSOR;
+		if (prevPid <= 0) continue;
+		for (int l = level + 1; l < (int)path.size(); l++)
+		{
+			if (nonleaf.read(prevPid, pf)) return RC_FILE_READ_FAILED;
+			if (nonleaf.readChildPtr(nonleaf.getKeyCount(), prevPid)) return RC_INVALID_CURSOR;
+		}
+		break;
+	}
+	if (prevPid > 0)
+	{
+		if (leaf.read(prevPid, pf)) return RC_FILE_READ_FAILED;
+		if (leaf.setNextNodePtr(nextPid)) return RC_FILE_WRITE_FAILED;
+		if (leaf.write(prevPid, pf)) return RC_FILE_WRITE_FAILED;
+	}
+	if (leafPid == lastLeafPid) lastLeafPid = prevPid;
+	if (pf.freePage(leafPid)) return RC_FILE_WRITE_FAILED;
+	leafCount--;
+	//remove the pointer to the leaf from its parent. the root always keeps
+	//at least two children, so the removal stops at the root at the latest
+	for (int level = path.size() - 1; level >= 0; level--)
+	{
+		if (nonleaf.read(path[level], pf)) return RC_FILE_READ_FAILED;
+		//drop an unused null pointer first, so that the node starts with a child
+		int n = index[level];
+		PageId first;
+		if (nonleaf.readChildPtr(0, first)) return RC_INVALID_CURSOR;
+		if (first <= 0 && nonleaf.getKeyCount() > 0)
+		{
+			if (nonleaf.removeChildPtr(0)) return RC_INVALID_CURSOR;
+			n--;
+		}
+		if (nonleaf.getKeyCount() > 0)
+		{
+			if (nonleaf.removeChildPtr(n)) return RC_INVALID_CURSOR;
+			if (nonleaf.write(path[level], pf)) return RC_FILE_WRITE_FAILED;
+			break;
+		}
+		if (pf.freePage(path[level])) return RC_FILE_WRITE_FAILED;
+	}
+	//shrink the tree while the root has a single child
+	while (treeHeight > 1)
+	{
+		if (nonleaf.read(rootPid, pf)) return RC_FILE_READ_FAILED;
+		PageId child;
+		if (nonleaf.readChildPtr(0, child)) return RC_INVALID_CURSOR;
+		if (child <= 0 && nonleaf.getKeyCount() == 1)
+		{
+			if (nonleaf.readChildPtr(1, child)) return RC_INVALID_CURSOR;
+		}
+		else if (nonleaf.getKeyCount() > 0) break;
+		if (pf.freePage(rootPid)) return RC_FILE_WRITE_FAILED;
+		rootPid = child;
+		treeHeight--;
+	}
+	return 0;
+}
+
+/*
+* Remove the (key, RecordId) pair from the index.
+* A leaf node left empty is taken out of the tree and its page is freed.
+* @param key[IN] the key of the pair to remove
+* @param rid[IN] the RecordId of the pair to remove
+* @return error code. RC_NO_SUCH_RECORD if the pair is not in the index
+*/
+RC BTreeIndex::remove(int key, const RecordId& rid)
+{
+	if (treeHeight == 0) return RC_NO_SUCH_RECORD;
+	//the pairs with the key may start in the leaf before the one the key
+	//leads to, so the search starts from the leaf of the next smaller key
+	vector<PageId> path;
+	vector<int> index;
+	PageId pid;
+	RC rc;
+	if ((rc = findPath(key == INT_MIN ? key : key - 1, path, index, pid)) < 0) return rc;
+	//the cached leaf of readForward may be changed below
+	currentPage = -1;
+	BTLeafNode leaf;
+	bool first = true;
+	while (pid > 0)
+	{
+		if (leaf.read(pid, pf)) return RC_FILE_READ_FAILED;
+		for (int eid = 0; eid < leaf.getKeyCount(); eid++)
+		{
+			int k;
+			RecordId r;
+			if (leaf.readEntry(eid, k, r)) return RC_INVALID_CURSOR;
+			if (k < key || (k == key && r != rid)) continue;
+			if (k > key) return RC_NO_SUCH_RECORD;
+			if (leaf.remove(eid)) return RC_INVALID_CURSOR;
+			if (leaf.write(pid, pf)) return RC_FILE_WRITE_FAILED;
+			//minKey stays as it is. it only has to be a lower bound
+			entryCount--;
+			if (leaf.getKeyCount() > 0 || treeHeight == 1) return 0;
+			//an empty leaf is taken out when its path is known. otherwise
+			//it stays in the chain and is skipped by readForward
+			if (!first)
+			{
+				PageId found;
+				if ((rc = findPath(key, path, index, found)) < 0) return rc;
+				if (found != pid) return 0;
+			}
+			return unlinkLeaf(path, index, pid, leaf.getNextNodePtr());
+		}
+		pid = leaf.getNextNodePtr();
+		first = false;
+	}
+	return RC_NO_SUCH_RECORD;
+}
+
+/*
+* Build the index bottom-up from (key, RecordId) pairs sorted by key.
+* The leaf nodes are filled and written in one sequential pass and
+* every upper level is built from the first keys of the level below.
+* The index must be empty when this function is called.
+* @param entries[IN] the (key, RecordId) pairs sorted by key
+* @return error code. 0 if no error
+*/
+RC BTreeIndex::bulkLoad(const vector<IndexEntry>& entries)
+{
+	if (treeHeight != 0) return RC_INVALID_FILE_FORMAT;
+	if (entries.empty()) return 0;
+	//the first key and the page id of every node on the level being built
+	vector<int> keys;
+	vector<PageId> pids;
+	//fill the leaf nodes with 80 entries each and chain them in page order
+	int n = entries.size();
+	PageId pid = pf.endPid();
+	for (int i = 0; i < n; i += 80)
+	{
+		BTLeafNode leaf;
+		for (int j = i; j < n && j < i + 80; j++)
+		{
+			if (leaf.insert(entries[j].key, entries[j].rid)) return RC_FILE_WRITE_FAILED;
+		}
+		//the last leaf has no next node
+		if (i + 80 < n && leaf.setNextNodePtr(pid + 1)) return RC_FILE_WRITE_FAILED;
+		if (leaf.write(pid, pf)) return RC_FILE_WRITE_FAILED;
+		keys.push_back(entries[i].key);
+		pids.push_back(pid++);
+	}
+	lastLeafPid = pids.back();
+	maxKey = entries[n - 1].key;
+	minKey = entries[0].key;
+	entryCount = n;
+	leafCount = pids.size();
+	treeHeight = 1;
+	//build the non-leaf levels until a single root is left
+	while (pids.size() > 1)
+	{
+		vector<int> upperKeys;
+		vector<PageId> upperPids;
+		//spread the children evenly so that every node gets at least two of them
+		int m = pids.size();
+		int nodeCount = (m + 120) / 121;
+		for (int i = 0; i < nodeCount; i++)
+		{
+			int begin = (int)((long long)m * i / nodeCount);
+			int end = (int)((long long)m * (i + 1) / nodeCount);
+			BTNonLeafNode nonleaf;
+			if (nonleaf.initializeRoot(pids[begin], keys[begin + 1], pids[begin + 1])) return RC_FILE_WRITE_FAILED;
+			for (int j = begin + 2; j < end; j++)
+			{
+				if (nonleaf.insert(keys[j], pids[j])) return RC_FILE_WRITE_FAILED;
+			}
+			if (pf.allocPage(pid)) return RC_FILE_WRITE_FAILED;
+			if (nonleaf.write(pid, pf)) return RC_FILE_WRITE_FAILED;
+			upperKeys.push_back(keys[begin]);
+			upperPids.push_back(pid);
+		}
+		keys.swap(upperKeys);
+		pids.swap(upperPids);
+		treeHeight++;
+	}
+	rootPid = pids[0];
+	return 0;
+}
+
 /*
 * Find the leaf-node index entry whose key value is larger than or
 * equal to searchKey, and output the location of the entry in IndexCursor.
@@ -216,18 +538,22 @@ RC BTreeIndex::locate(int searchKey, IndexCursor& cursor)
 	BTLeafNode *leaf = new BTLeafNode();
 	BTNonLeafNode *nonleaf = new BTNonLeafNode();
 	PageId pid = rootPid;
+	//the pairs with the key may start in the leaf before the one the key
+	//leads to, so the search goes down by the next smaller key, as in remove()
+	int pathKey = searchKey == INT_MIN ? searchKey : searchKey - 1;
 	//determine the pid the target leaf node
 	for (int i = 0; i < treeHeight - 1; i++)
 	{
 		//read the content of certain page file with page id equals to pid
 		if (nonleaf->read(pid, pf)) return RC_FILE_READ_FAILED;
 		//locate the target child that could point to the search key
-		if (nonleaf->locateChildPtr(searchKey, pid)) return RC_FILE_SEEK_FAILED;
+		if (nonleaf->locateChildPtr(pathKey, pid)) return RC_FILE_SEEK_FAILED;
 	}
 	//now pid stores the pid of the target leaf node
 	//read the content of certain page file with page id equals to pid
 	if (leaf->read(pid, pf)) return RC_FILE_READ_FAILED;
-	//locate the target entry with search key in the leaf node
+	//locate the target entry with search key in the leaf node. past the
+	//last entry, readForward() goes on with the next leaf node
 	int eid = -1;
 	if (leaf->locate(searchKey, eid)) return RC_FILE_SEEK_FAILED;
 	//store the two indices into the index cursor
@@ -236,6 +562,104 @@ RC BTreeIndex::locate(int searchKey, IndexCursor& cursor)
 	return 0;
 }
 
+/*
+* Get the statistics of the index.
+* @param count[OUT] # (key, RecordId) pairs in the index
+* @param low[OUT] a lower bound of the keys in the index
+* @param high[OUT] an upper bound of the keys in the index
+* @param leaves[OUT] # leaf nodes in the index
+* @return error code. RC_INVALID_FILE_FORMAT if the index keeps no statistics
+*/
+RC BTreeIndex::getStats(int& count, int& low, int& high, int& leaves) const
+{
+	if (!statsValid) return RC_INVALID_FILE_FORMAT;
+	count = entryCount;
+	leaves = leafCount;
+	low = minKey;
+	high = maxKey;
+	return 0;
+}
+
+/*
+* Count the (key, RecordId) pairs with keys from low to high in the
+* first maxLeaves leaf nodes of the range.
+* @param low[IN] the smallest key of the range
+* @param high[IN] the largest key of the range
+* @param maxLeaves[IN] # leaf nodes to read at most
+* @param count[OUT] # pairs counted
+* @param lastKey[OUT] the last key counted, or low if none
+* @param complete[OUT] whether all the pairs of the range were counted
+* @return error code. 0 if no error
+*/
+RC BTreeIndex::countRange(int low, int high, int maxLeaves, int& count, int& lastKey, bool& complete)
+{
+	count = 0;
+	lastKey = low;
+	complete = true;
+	IndexCursor cursor;
+	//an empty tree has no pair to count
+	if (locate(low, cursor) != 0) return 0;
+	PageId pid = cursor.pid;
+	int leaves = 1;
+	int key;
+	RecordId rid;
+	RC rc;
+	while ((rc = readForward(cursor, key, rid)) == 0 && key <= high)
+	{
+		//the pair read is in the next leaf node
+		if (cursor.pid != pid)
+		{
+			pid = cursor.pid;
+			if (++leaves > maxLeaves)
+			{
+				complete = false;
+				return 0;
+			}
+		}
+		count++;
+		lastKey = key;
+	}
+	return rc == RC_END_OF_TREE ? 0 : rc;
+}
+
+/*
+* Return the height of the tree.
+* @return # levels of the tree. 0 if the tree is empty
+*/
+int BTreeIndex::getHeight() const
+{
+	return treeHeight;
+}
+
+/*
+* Read the largest key in the tree from the rightmost leaf node.
+* @param key[OUT] the largest key
+* @return error code. RC_NO_SUCH_RECORD if the tree is empty
+*/
+RC BTreeIndex::readLastKey(int& key)
+{
+	if (treeHeight == 0) return RC_NO_SUCH_RECORD;
+	//the rightmost leaf node is kept in the header, so a single node is read.
+	//otherwise follow the last child pointer of every non-leaf node down to it
+	PageId pid = lastLeafPid;
+	if (pid <= 0)
+	{
+		BTNonLeafNode nonleaf;
+		pid = rootPid;
+		for (int i = 0; i < treeHeight - 1; i++)
+		{
+			if (nonleaf.read(pid, pf)) return RC_FILE_READ_FAILED;
+			if (nonleaf.readChildPtr(nonleaf.getKeyCount(), pid)) return RC_FILE_SEEK_FAILED;
+		}
+	}
+	BTLeafNode leaf;
+	if (leaf.read(pid, pf)) return RC_FILE_READ_FAILED;
+	int count = leaf.getKeyCount();
+	if (count == 0) return RC_NO_SUCH_RECORD;
+	RecordId rid;
+	return leaf.readEntry(count - 1, key, rid);
+}
+
 /*
 * Read the (key, rid) pair at the location specified by the index cursor,
 * and move foward the cursor to the next entry.
@@ -252,8 +676,9 @@ RC BTreeIndex::readForward(IndexCursor& cursor, int& key, RecordId& rid)
 		if (currentReadNode->read(cursor.pid, pf)) return RC_FILE_READ_FAILED;
 		currentPage = cursor.pid;
 	}
-	//if exceed the last entry of the node, go to the first entry of the next node
-	if (cursor.eid == currentReadNode->getKeyCount())
+	//if exceed the last entry of the node, go to the first entry of the next node.
+	//a leaf node emptied by remove() may be passed over
+	while (cursor.eid >= currentReadNode->getKeyCount())
 	{
 		//set the pid to the next node if it exists
 		if ((cursor.pid = currentReadNode->getNextNodePtr()) <= 0) return RC_END_OF_TREE;
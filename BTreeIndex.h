@@ -10,6 +10,7 @@
 #ifndef BTREEINDEX_H
 #define BTREEINDEX_H
 
+#include <vector>
 #include "Bruinbase.h"
 #include "PageFile.h"
 #include "RecordFile.h"
@@ -28,6 +29,14 @@ typedef struct {
   int     eid;  
 } IndexCursor;
 
+/**
+ * A (key, RecordId) pair to be loaded into a B+tree in bulk.
+ */
+typedef struct {
+  int      key;
+  RecordId rid;
+} IndexEntry;
+
 /**
  * Implements a B-Tree index for bruinbase.
  * 
@@ -73,6 +82,26 @@ class BTreeIndex {
   RC insertHelp(int key, const RecordId& rid, int currentHeight, PageId currentPid, int& sibingKey, PageId& ipid);
   RC insert(int key, const RecordId& rid);
 
+  /**
+   * Build the index bottom-up from (key, RecordId) pairs sorted by key.
+   * The leaf nodes are filled and written in one sequential pass and
+   * every upper level is built from the first keys of the level below.
+   * The index must be empty when this function is called.
+   * @param entries[IN] the (key, RecordId) pairs sorted by key
+   * @return error code. 0 if no error
+   */
+  RC bulkLoad(const std::vector<IndexEntry>& entries);
+
+  /**
+   * Remove (key, RecordId) pair from the index.
+   * A leaf node left empty is taken out of the tree and its page
+   * is put on the free list of the index file.
+   * @param key[IN] the key of the pair to remove
+   * @param rid[IN] the RecordId of the pair to remove
+   * @return error code. RC_NO_SUCH_RECORD if the pair is not in the index
+   */
+  RC remove(int key, const RecordId& rid);
+
   /**
    * Find the leaf-node index entry whose key value is larger than or
    * equal to searchKey and output its location (i.e., the page id of the node
@@ -104,11 +133,59 @@ class BTreeIndex {
    * @return error code. 0 if no error
    */
   RC readForward(IndexCursor& cursor, int& key, RecordId& rid);
+
+  /**
+   * Get the statistics of the index, which are kept up to date
+   * by insert(), remove() and bulkLoad().
+   * @param count[OUT] # (key, RecordId) pairs in the index
+   * @param low[OUT] a lower bound of the keys in the index
+   * @param high[OUT] an upper bound of the keys in the index
+   * @param leaves[OUT] # leaf nodes in the index
+   * @return error code. RC_INVALID_FILE_FORMAT if the index was
+   * written without statistics
+   */
+  RC getStats(int& count, int& low, int& high, int& leaves) const;
+
+  /**
+   * Count the (key, RecordId) pairs with keys from low to high in the
+   * first maxLeaves leaf nodes of the range.
+   * @param low[IN] the smallest key of the range
+   * @param high[IN] the largest key of the range
+   * @param maxLeaves[IN] # leaf nodes to read at most
+   * @param count[OUT] # pairs counted
+   * @param lastKey[OUT] the last key counted, or low if none
+   * @param complete[OUT] whether all the pairs of the range were counted
+   * @return error code. 0 if no error
+   */
+  RC countRange(int low, int high, int maxLeaves, int& count, int& lastKey, bool& complete);
+
+  /**
+   * @return # levels of the tree. 0 if the tree is empty
+   */
+  int getHeight() const;
+
+  /**
+   * Read the largest key in the tree. Only the rightmost leaf node is read
+   * when its PageId is kept in the index file.
+   * @param key[OUT] the largest key
+   * @return error code. RC_NO_SUCH_RECORD if the tree is empty
+   */
+  RC readLastKey(int& key);
   
  private:
+  RC findPath(int key, std::vector<PageId>& path, std::vector<int>& index, PageId& leafPid);
+  RC unlinkLeaf(const std::vector<PageId>& path, const std::vector<int>& index, PageId leafPid, PageId nextPid);
+
   PageFile pf;         /// the PageFile used to store the actual b+tree in disk
   PageId   rootPid;    /// the PageId of the root node
   int      treeHeight; /// the height of the tree
+  PageId   lastLeafPid;/// the PageId of the rightmost leaf node
+  int      maxKey;     /// the largest key in the tree
+  int      minKey;     /// a lower bound of the keys in the tree
+  int      entryCount; /// # (key, RecordId) pairs in the tree
+  int      leafCount;  /// # leaf nodes in the tree
+  bool     statsValid; /// whether minKey, entryCount and leafCount are kept
+  bool     readOnly;   /// whether the index was opened in 'r' mode
 
   PageId	 currentPage;	  /// variable for the readForward function, to store the pid of the current read page
   BTLeafNode *currentReadNode;/* 
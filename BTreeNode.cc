@@ -71,10 +71,10 @@ RC BTLeafNode::insert(int key, const RecordId& rid)
 	int temp = 0; //temporarily stores the key of entry in buffer
 	int smallCount = 0; //count the number of entries with key smaller than inserted key
 	//look for the key of entry larger or equal to the key
-	while (it)
+	while (smallCount < count)
 	{
 		memcpy(&temp, it, sizeof(int));
-		if (temp == 0 || temp >= key) break;
+		if (temp >= key) break;
 		else it += sizeof(int) + sizeof(RecordId);
 		smallCount++;
 	}
@@ -99,6 +99,10 @@ RC BTLeafNode::insert(int key, const RecordId& rid)
 /*
  * Insert the (key, rid) pair to the node
  * and split the node half and half with sibling.
+ * If the node is the rightmost leaf and the key is larger than every key in it,
+ * the keys are most likely arriving in ascending order (e.g. timestamps).
+ * In that case the node is split at the insertion point instead: it stays full
+ * and the sibling starts with the new key only.
  * The first key of the sibling node is returned in siblingKey.
  * @param key[IN] the key to insert.
  * @param rid[IN] the RecordId to insert.
@@ -109,25 +113,36 @@ RC BTLeafNode::insert(int key, const RecordId& rid)
 RC BTLeafNode::insertAndSplit(int key, const RecordId& rid, 
                               BTLeafNode& sibling, int& siblingKey)
 {
+	int count = getKeyCount();
+	int tempKey = 0;
+	RecordId tempRid;
+	//read the largest key in the node to detect rightmost insertion
+	if (readEntry(count - 1, tempKey, tempRid)) return RC_FILE_READ_FAILED;
+	//number of entries to keep in this node
+	int keep = count / 2;
+	if (getNextNodePtr() == 0 && key > tempKey) keep = count;
 	char *it = buffer; //create iterator from begin of buffer
 	it += sizeof(int) + sizeof(PageId); //pass the key count and pointer to the next node;
-	int half = getKeyCount() / 2;
-	for (int i = 0; i < half; i++) it += sizeof(int) + sizeof(RecordId); //iterator points to the middle pair
+	it += keep * (sizeof(int) + sizeof(RecordId)); //iterator points to the first pair to move
 	char *middle = it; //maintain a pointer to the middle pair before it being modified
-	//copy the right half to the sibling node;
-	int tempKey = 0;
-	RecordId tempRid;
-	while (it)
+	//copy the right part to the sibling node;
+	for (int i = keep; i < count; i++)
 	{
 		memcpy(&tempKey, it, sizeof(int));
 		it += sizeof(int);
 		memcpy(&tempRid, it, sizeof(RecordId));
 		it += sizeof(RecordId);
-		if (!tempKey) break;
 		if (sibling.insert(tempKey, tempRid)) return RC_FILE_WRITE_FAILED;
 	}
-	memset(middle, 0, half * (sizeof(int) + sizeof(RecordId))); //clear the right half of the node;
-	memcpy(buffer, &half, sizeof(int)); //update the new key count to the node;
+	memset(middle, 0, (count - keep) * (sizeof(int) + sizeof(RecordId))); //clear the right part of the node;
+	memcpy(buffer, &keep, sizeof(int)); //update the new key count to the node;
+	//in the case of rightmost insertion, the new key is the only entry of the sibling
+	if (keep == count)
+	{
+		if (sibling.insert(key, rid)) return RC_FILE_WRITE_FAILED;
+		siblingKey = key;
+		return 0;
+	}
 	if (sibling.readEntry(0, siblingKey, tempRid)) return RC_FILE_READ_FAILED; //store temporarily first key in siblingKey
 	if (siblingKey < key)
 	{
@@ -153,11 +168,12 @@ RC BTLeafNode::locate(int searchKey, int& eid)
 	char *it = buffer; //create iterator from begin of buffer
 	it += sizeof(int) + sizeof(PageId); //pass the key count and pointer to the next node
 	int temp = 0;
+	int count = getKeyCount();
 	eid = 0;
-	while (it)
+	while (eid < count)
 	{
 		memcpy(&temp, it, sizeof(int));
-		if (temp == 0 || temp >= searchKey) break;
+		if (temp >= searchKey) break;
 		else it += sizeof(int) + sizeof(RecordId);
 		eid++;
 	}
@@ -182,6 +198,26 @@ RC BTLeafNode::readEntry(int eid, int& key, RecordId& rid)
 	return 0;
 }
 
+/*
+ * Remove the (key, rid) pair of the eid entry from the node.
+ * @param eid[IN] the entry number to remove
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTLeafNode::remove(int eid)
+{
+	int count = getKeyCount();
+	if (eid < 0 || eid >= count) return RC_INVALID_CURSOR;
+	int size = sizeof(int) + sizeof(RecordId); //the size of an entry
+	char *it = buffer + sizeof(int) + sizeof(PageId) + eid * size; //go to the location
+	//move the following entries forward by one and clear the last one,
+	//since the search stops at the first empty key
+	memmove(it, it + size, (count - eid - 1) * size);
+	memset(buffer + sizeof(int) + sizeof(PageId) + (count - 1) * size, 0, size);
+	count--;
+	memcpy(buffer, &count, sizeof(int));
+	return 0;
+}
+
 /*
  * Return the pid of the next slibling node.
  * @return the PageId of the next sibling node 
@@ -269,6 +305,51 @@ RC BTNonLeafNode::readEntry(int eid, int& key, PageId& pid)
 	return 0;
 }
 
+/*
+ * Read the pointer to the index'th child of the node.
+ * @param index[IN] the child number. the first child is 0
+ * @param pid[OUT] the PageId of the child
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTNonLeafNode::readChildPtr(int index, PageId& pid)
+{
+	if (index < 0 || index > getKeyCount()) return RC_INVALID_CURSOR;
+	//the first child comes before the first key, every other one after its key
+	char *it = buffer + sizeof(int);
+	if (index > 0) it += sizeof(PageId) + (index - 1) * (sizeof(int) + sizeof(PageId)) + sizeof(int);
+	memcpy(&pid, it, sizeof(PageId));
+	return 0;
+}
+
+/*
+ * Remove the pointer to the index'th child from the node, together
+ * with the key in front of it. When the first child is removed, the
+ * second child takes its place and the first key is removed.
+ * @param index[IN] the child number. the first child is 0
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTNonLeafNode::removeChildPtr(int index)
+{
+	int count = getKeyCount();
+	if (index < 0 || index > count || count == 0) return RC_INVALID_CURSOR;
+	int size = sizeof(int) + sizeof(PageId); //the size of a (key, pid) pair
+	char *first = buffer + sizeof(int) + sizeof(PageId); //the first pair
+	int eid = index - 1;
+	if (index == 0)
+	{
+		//the child of the first pair becomes the first child
+		memcpy(buffer + sizeof(int), first + sizeof(int), sizeof(PageId));
+		eid = 0;
+	}
+	//move the following pairs forward by one and clear the last one,
+	//since the search stops at the first empty key
+	memmove(first + eid * size, first + (eid + 1) * size, (count - eid - 1) * size);
+	memset(first + (count - 1) * size, 0, size);
+	count--;
+	memcpy(buffer, &count, sizeof(int));
+	return 0;
+}
+
 /*
  * Insert a (key, pid) pair to the node.
  * @param key[IN] the key to insert
@@ -289,14 +370,14 @@ RC BTNonLeafNode::insert(int key, PageId pid)
 	int temp = 0; //temporarily stores the key of entry in buffer
 	int smallCount = 0; //count the number of entries with key smaller than inserted key
 	//look for the key of entry larger or equal to the key
-	while (it)
+	while (smallCount < count)
 	{
 		memcpy(&temp, it, sizeof(int));
-		if (temp == 0 || temp >= key) break;
+		if (temp >= key) break;
 		else it += sizeof(int) + sizeof(PageId);
 		smallCount++;
 	}
-	if (temp == key)
+	if (smallCount < count && temp == key)
 	{
 		it += sizeof(int);
 		memcpy(it, &pid, sizeof(PageId));
@@ -323,6 +404,9 @@ RC BTNonLeafNode::insert(int key, PageId pid)
 /*
  * Insert the (key, pid) pair to the node
  * and split the node half and half with sibling.
+ * If the key is larger than every key in the node, the node is split at the
+ * insertion point instead: it stays full and the sibling holds the new key only.
+ * This keeps the nodes full when keys arrive in ascending order.
  * The middle key after the split is returned in midKey.
  * @param key[IN] the key to insert
  * @param pid[IN] the PageId to insert
@@ -332,26 +416,34 @@ RC BTNonLeafNode::insert(int key, PageId pid)
  */
 RC BTNonLeafNode::insertAndSplit(int key, PageId pid, BTNonLeafNode& sibling, int& midKey)
 {
+	int count = getKeyCount();
+	int tempKey = 0;
+	PageId tempPid;
+	//read the largest key in the node to detect rightmost insertion
+	if (readEntry(count - 1, tempKey, tempPid)) return RC_FILE_READ_FAILED;
+	if (key > tempKey)
+	{
+		//the new key is pulled to the parent node and starts the sibling
+		if (sibling.insert(key, pid)) return RC_FILE_WRITE_FAILED;
+		midKey = key;
+		return 0;
+	}
 	char *it = buffer; //create iterator from begin of buffer
 	it += sizeof(int) + sizeof(PageId); //pass the key count and the first page if;
-	int half = getKeyCount() / 2;
-	for (int i = 0; i < half; i++) it += sizeof(int) + sizeof(PageId); //iterator points to the middle pair
+	int half = count / 2;
+	it += half * (sizeof(int) + sizeof(PageId)); //iterator points to the middle pair
 	char *middle = it; //maintain a pointer to the middle pair before it being modified
 	memcpy(&midKey, it, sizeof(int)); //pull the middle key to the parent node
-	//it += sizeof(int) + sizeof(PageId);
 	//copy the right half to the sibling node;
-	int tempKey = 0;
-	PageId tempPid;
-	while (it)
+	for (int i = half; i < count; i++)
 	{
 		memcpy(&tempKey, it, sizeof(int));
 		it += sizeof(int);
 		memcpy(&tempPid, it, sizeof(PageId));
 		it += sizeof(PageId);
-		if (!tempKey) break;
 		if (sibling.insert(tempKey, tempPid)) return RC_FILE_WRITE_FAILED;
 	}
-	memset(middle, 0, half * (sizeof(int) + sizeof(PageId))); //clear the right half of the node;
+	memset(middle, 0, (count - half) * (sizeof(int) + sizeof(PageId))); //clear the right half of the node;
 	memcpy(buffer, &half, sizeof(int)); //update the new key count to the node;
 	if (midKey < key)
 	{
@@ -378,10 +470,11 @@ RC BTNonLeafNode::locateChildPtr(int searchKey, PageId& pid)
 	memcpy(&pid, it, sizeof(PageId)); //assign the first page id to the pid
 	it += sizeof(PageId); //pass the first page id
 	int temp = 0;
-	while (it)
+	int count = getKeyCount();
+	for (int i = 0; i < count; i++)
 	{
 		memcpy(&temp, it, sizeof(int));
-		if (temp == 0 || temp > searchKey) break;
+		if (temp > searchKey) break;
 		it += sizeof(int);
 		memcpy(&pid, it, sizeof(PageId));
 		it += sizeof(PageId);
@@ -31,6 +31,8 @@ class BTLeafNode {
    /**
     * Insert the (key, rid) pair to the node
     * and split the node half and half with sibling.
+    * When the key goes to the end of the rightmost leaf, the node is
+    * split at the insertion point instead so that it stays full.
     * The first key of the sibling node is returned in siblingKey.
     * Remember that all keys inside a B+tree node should be kept sorted.
     * @param key[IN] the key to insert.
@@ -61,6 +63,13 @@ class BTLeafNode {
     */
     RC readEntry(int eid, int& key, RecordId& rid);
 
+   /**
+    * Remove the (key, rid) pair of the eid entry from the node.
+    * @param eid[IN] the entry number to remove
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC remove(int eid);
+
    /**
     * Return the pid of the next slibling node.
     * @return the PageId of the next sibling node 
@@ -124,6 +133,8 @@ class BTNonLeafNode {
    /**
     * Insert the (key, pid) pair to the node
     * and split the node half and half with sibling.
+    * When the key is larger than every key in the node, the node is
+    * split at the insertion point instead so that it stays full.
     * The sibling node MUST be empty when this function is called.
     * The middle key after the split is returned in midKey.
     * Remember that all keys inside a B+tree node should be kept sorted.
@@ -163,6 +174,22 @@ class BTNonLeafNode {
 	*/
 	RC readEntry(int eid, int& key, PageId& pid);
 
+   /**
+    * Read the pointer to the index'th child of the node.
+    * @param index[IN] the child number. the first child is 0
+    * @param pid[OUT] the PageId of the child
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC readChildPtr(int index, PageId& pid);
+
+   /**
+    * Remove the pointer to the index'th child from the node,
+    * together with the key that separates it from its neighbor.
+    * @param index[IN] the child number. the first child is 0
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC removeChildPtr(int index);
+
    /**
     * Return the number of keys stored in the node.
     * @return the number of keys in the node
@@ -0,0 +1,199 @@
+/**
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#include <cstring>
+#include <cstdio>
+#include "Bruinbase.h"
+#include "PageFile.h"
+#include "BloomFilter.h"
+
+using std::string;
+
+//
+// A filter file stores # blocks and # keys inserted in its first page,
+// followed by the blocks of the filter, PageFile::PAGE_SIZE / BLOCK_SIZE
+// blocks to a page. A file written before # keys was kept has 0 there.
+//
+
+// # blocks per page of the filter file
+static const int BLOCKS_PER_PAGE = PageFile::PAGE_SIZE / BloomFilter::BLOCK_SIZE;
+
+// mix the bits of a key into a 64-bit hash value
+static unsigned long long hashKey(int key);
+
+
+BloomFilter::BloomFilter()
+{
+  blockCount = 0;
+  keyCount = 0;
+}
+
+void BloomFilter::init(int keyCount)
+{
+  // keep at least one block so that an empty filter rejects every key
+  blockCount = (keyCount * BITS_PER_KEY + BLOCK_SIZE*8 - 1) / (BLOCK_SIZE*8);
+  if (blockCount < 1) blockCount = 1;
+  this->keyCount = 0;
+  bits.assign(blockCount * BLOCK_SIZE, 0);
+  pageLoaded.assign((blockCount + BLOCKS_PER_PAGE - 1) / BLOCKS_PER_PAGE, true);
+}
+
+void BloomFilter::insert(int key)
+{
+  if (blockCount == 0) return;
+
+  // the upper half of the hash generates the bit positions within the block
+  unsigned long long h = hashKey(key);
+  unsigned char* block = getBlock(h);
+  if (block == NULL) return;
+  keyCount++;
+  unsigned b = (unsigned)(h >> 32);
+  unsigned delta = (b >> 17) | (b << 15);
+  for (int i = 0; i < HASH_COUNT; i++) {
+    unsigned pos = b % (BLOCK_SIZE*8);
+    block[pos / 8] |= 1 << (pos % 8);
+    b += delta;
+  }
+}
+
+bool BloomFilter::mayContain(int key)
+{
+  // a filter that was never built or cannot be read rules nothing out
+  if (blockCount == 0) return true;
+
+  unsigned long long h = hashKey(key);
+  const unsigned char* block = getBlock(h);
+  if (block == NULL) return true;
+  unsigned b = (unsigned)(h >> 32);
+  unsigned delta = (b >> 17) | (b << 15);
+  for (int i = 0; i < HASH_COUNT; i++) {
+    unsigned pos = b % (BLOCK_SIZE*8);
+    if ((block[pos / 8] & (1 << (pos % 8))) == 0) return false;
+    b += delta;
+  }
+  return true;
+}
+
+RC BloomFilter::save(const string& filename) const
+{
+  RC       rc;
+  PageFile pf;
+  char     page[PageFile::PAGE_SIZE];
+
+  // a filter opened from a file can be written only when fully read
+  for (unsigned i = 0; i < pageLoaded.size(); i++) {
+    if (!pageLoaded[i]) return RC_INVALID_FILE_FORMAT;
+  }
+
+  // start from an empty file
+  remove(filename.c_str());
+  if ((rc = pf.open(filename, 'w')) < 0) return rc;
+
+  memset(page, 0, PageFile::PAGE_SIZE);
+  memcpy(page, &blockCount, sizeof(int));
+  memcpy(page + sizeof(int), &keyCount, sizeof(int));
+  if ((rc = pf.write(0, page)) < 0) goto exit_save;
+
+  for (int i = 0; i < blockCount; i += BLOCKS_PER_PAGE) {
+    int n = (blockCount - i < BLOCKS_PER_PAGE) ? blockCount - i : BLOCKS_PER_PAGE;
+    memset(page, 0, PageFile::PAGE_SIZE);
+    memcpy(page, &bits[i * BLOCK_SIZE], n * BLOCK_SIZE);
+    if ((rc = pf.write(1 + i / BLOCKS_PER_PAGE, page)) < 0) goto exit_save;
+  }
+
+  exit_save:
+  pf.close();
+  return rc;
+}
+
+RC BloomFilter::open(const string& filename)
+{
+  RC       rc;
+  PageFile pf;
+  char     page[PageFile::PAGE_SIZE];
+  int      count;
+
+  if ((rc = pf.open(filename, 'r')) < 0) return rc;
+
+  if ((rc = pf.read(0, page)) < 0) goto exit_open;
+  memcpy(&count, page, sizeof(int));
+  if (count < 1 || 1 + (count + BLOCKS_PER_PAGE - 1) / BLOCKS_PER_PAGE > pf.endPid()) {
+    rc = RC_INVALID_FILE_FORMAT;
+    goto exit_open;
+  }
+
+  this->filename = filename;
+  blockCount = count;
+  memcpy(&keyCount, page + sizeof(int), sizeof(int));
+  bits.assign(count * BLOCK_SIZE, 0);
+  pageLoaded.assign((count + BLOCKS_PER_PAGE - 1) / BLOCKS_PER_PAGE, false);
+
+  exit_open:
+  pf.close();
+  return rc;
+}
+
+RC BloomFilter::read(const string& filename)
+{
+  RC       rc;
+  PageFile pf;
+  char     page[PageFile::PAGE_SIZE];
+
+  if ((rc = open(filename)) < 0) return rc;
+  if (keyCount <= 0) return RC_INVALID_FILE_FORMAT;
+  if ((rc = pf.open(filename, 'r')) < 0) return rc;
+
+  for (unsigned p = 0; p < pageLoaded.size(); p++) {
+    if ((rc = pf.read(1 + p, page)) < 0) break;
+    int first = p * BLOCKS_PER_PAGE;
+    int count = (blockCount - first < BLOCKS_PER_PAGE) ? blockCount - first : BLOCKS_PER_PAGE;
+    memcpy(&bits[first * BLOCK_SIZE], page, count * BLOCK_SIZE);
+    pageLoaded[p] = true;
+  }
+
+  pf.close();
+  return rc;
+}
+
+unsigned char* BloomFilter::getBlock(unsigned long long hash)
+{
+  // the lower half of the hash picks the block
+  int n = (unsigned)hash % blockCount;
+  int p = n / BLOCKS_PER_PAGE;
+
+  // read the page of the block unless it is already in memory
+  if (!pageLoaded[p]) {
+    PageFile pf;
+    char     page[PageFile::PAGE_SIZE];
+    if (pf.open(filename, 'r') < 0) return NULL;
+    if (pf.read(1 + p, page) < 0) {
+      pf.close();
+      return NULL;
+    }
+    pf.close();
+
+    int first = p * BLOCKS_PER_PAGE;
+    int count = (blockCount - first < BLOCKS_PER_PAGE) ? blockCount - first : BLOCKS_PER_PAGE;
+    memcpy(&bits[first * BLOCK_SIZE], page, count * BLOCK_SIZE);
+    pageLoaded[p] = true;
+  }
+
+  return &bits[n * BLOCK_SIZE];
+}
+
+static unsigned long long hashKey(int key)
+{
+  // the finalizer of MurmurHash3
+  unsigned long long h = (unsigned)key;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <string>
+#include <vector>
+#include "Bruinbase.h"
+
+/**
+ * blocked Bloom filter on the keys of a table.
+ * every key sets HASH_COUNT bits within a single BLOCK_SIZE-byte block,
+ * so a probe touches one block only. a filter read from a file loads
+ * the page of a block on the first probe that needs it.
+ * mayContain() never returns false for an inserted key.
+ */
+class BloomFilter {
+ public:
+
+  static const int BLOCK_SIZE = 64;     // the size of a block in bytes
+  static const int BITS_PER_KEY = 10;   // # filter bits per key
+  static const int HASH_COUNT = 6;      // # bits set for every key
+
+  BloomFilter();
+
+  /**
+   * clear the filter and size it for the given number of keys.
+   * @param keyCount[IN] the number of keys to be inserted
+   */
+  void init(int keyCount);
+
+  /**
+   * @return # keys inserted into the filter
+   */
+  int getKeyCount() const { return keyCount; }
+
+  /**
+   * @return # keys the filter is sized for
+   */
+  int getCapacity() const { return blockCount * BLOCK_SIZE * 8 / BITS_PER_KEY; }
+
+  /**
+   * insert a key into the filter.
+   * @param key[IN] the key to insert
+   */
+  void insert(int key);
+
+  /**
+   * check whether a key may have been inserted.
+   * @param key[IN] the key to look up
+   * @return false if the key was definitely not inserted
+   */
+  bool mayContain(int key);
+
+  /**
+   * write the filter to a file.
+   * @param filename[IN] the name of the file
+   * @return error code. 0 if no error
+   */
+  RC save(const std::string& filename) const;
+
+  /**
+   * open a filter written by save(). only the size of the filter is
+   * read here. the blocks are read by mayContain() when needed.
+   * @param filename[IN] the name of the file
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& filename);
+
+  /**
+   * read a whole filter written by save(), so that more keys can be
+   * inserted and the filter saved again.
+   * @param filename[IN] the name of the file
+   * @return error code. 0 if no error. RC_INVALID_FILE_FORMAT if the
+   * file does not keep # keys in the filter
+   */
+  RC read(const std::string& filename);
+
+ private:
+  unsigned char* getBlock(unsigned long long hash);
+
+  std::string filename;             // the file of the filter
+  int blockCount;                   // # blocks in the filter
+  int keyCount;                     // # keys inserted
+  std::vector<unsigned char> bits;  // the filter bits
+  std::vector<bool> pageLoaded;     // whether a page of the file is in bits
+};
+
+#endif // BLOOMFILTER_H
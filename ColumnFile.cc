@@ -0,0 +1,529 @@
+/**
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#include <cstring>
+#include <algorithm>
+#include "Bruinbase.h"
+#include "ColumnFile.h"
+
+using std::string;
+using std::vector;
+
+//
+// The key column (table.key.col) stores # rows and the format of the
+// value column in its first page, followed by the keys packed
+// KEYS_PER_PAGE to a page. The key of row r is in page 1 + r/KEYS_PER_PAGE.
+//
+// The value column (table.value.col) stores # rows and # data pages in its
+// first page, followed by the data pages and the directory pages.
+// A data page has the following layout:
+//
+// |count|first row|offset 0|...|offset n-1|  free space  |value n-1|...|value 0|
+//
+// The first row is the row number of value 0 and offset i is the location
+// of value i in the page. Values are stored from the end of the page without
+// the terminating zero, so value i ends where value i-1 starts.
+// The directory pages store the first row of every data page, so that
+// the page of a row can be found without reading the data pages.
+//
+// In the DICTIONARY format, the code column (table.code.col) takes the
+// place of the value column and is laid out like the key column without
+// its first page. The dictionary (table.dict.col) stores # codes in its
+// first page, followed by the values of the codes in order. A dictionary
+// page stores # values in its first four bytes and every value as its
+// length in one byte followed by the value.
+//
+
+// the size of the header of a value page
+static const int VALUE_HEADER_SIZE = 2*sizeof(int);
+
+// get # values stored in the value page
+static int getValueCount(const char* page);
+
+// get the row number of the first value in the value page
+static int getFirstRow(const char* page);
+
+// get the location of the n'th value in the value page
+static int getValueOffset(const char* page, int n);
+
+// get # free bytes in the value page
+static int getFreeSpace(const char* page);
+
+// add a value at the end of the value page
+static void addValue(char* page, const char* value, int length);
+
+// initialize an empty value page starting at the given row
+static void initValuePage(char* page, int firstRow);
+
+
+ColumnFile::ColumnFile()
+{
+  mode = 0;
+  format = PLAIN;
+  rowCount = 0;
+  valuePages = -1;
+  dictLoaded = false;
+  keyPid = valuePid = codePid = -1;
+}
+
+RC ColumnFile::open(const string& table, char mode, int format)
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  // open the key column
+  if ((rc = kf.open(table + ".key.col", mode)) < 0) return rc;
+  this->table = table;
+  this->mode = mode;
+
+  // the first page of the key column stores # rows and the format
+  rowCount = 0;
+  this->format = PLAIN;
+  if (kf.endPid() > 0) {
+    if ((rc = kf.read(0, page)) < 0) goto open_failed;
+    memcpy(&rowCount, page, sizeof(int));
+    memcpy(&this->format, page + 2*sizeof(int), sizeof(int));
+  }
+
+  // the value column is opened on first use when reading.
+  // when writing, the last pages of the columns are kept in memory
+  // until they are full or the file is closed.
+  if (mode == 'w' || mode == 'W') {
+    // an empty table takes the requested format
+    if (rowCount == 0) {
+      this->format = format;
+    } else if (this->format != format) {
+      rc = RC_INVALID_FILE_FORMAT;
+      goto open_failed;
+    }
+
+    if (rowCount % KEYS_PER_PAGE != 0) {
+      keyPid = 1 + rowCount / KEYS_PER_PAGE;
+      if ((rc = kf.read(keyPid, keyPage)) < 0) goto open_failed;
+    }
+
+    if (this->format == DICTIONARY) {
+      if ((rc = openCodes()) < 0) goto open_failed;
+      if (rowCount % KEYS_PER_PAGE != 0) {
+        codePid = keyPid - 1;
+        if ((rc = cf.read(codePid, codePage)) < 0) goto open_failed;
+      }
+    } else {
+      if ((rc = openValues()) < 0 || (rc = readDirectory()) < 0) goto open_failed;
+      if (valuePages > 0) {
+        valuePid = valuePages;
+        if ((rc = vf.read(valuePid, valuePage)) < 0) goto open_failed;
+      }
+    }
+  }
+
+  return 0;
+
+  // close the files without writing anything
+  open_failed:
+  this->mode = 0;
+  close();
+  return rc;
+}
+
+RC ColumnFile::close()
+{
+  RC   rc = 0;
+  char page[PageFile::PAGE_SIZE];
+
+  if (mode == 'w' || mode == 'W') {
+    // write the partially filled pages still in memory
+    if (rowCount % KEYS_PER_PAGE != 0 && (rc = kf.write(keyPid, keyPage)) < 0) goto exit_close;
+
+    if (format == DICTIONARY) {
+      if (rowCount % KEYS_PER_PAGE != 0 && (rc = cf.write(codePid, codePage)) < 0) goto exit_close;
+      if ((rc = writeDictionary()) < 0) goto exit_close;
+    } else {
+      if (valuePid > 0 && (rc = writeValuePage()) < 0) goto exit_close;
+
+      // write the directory after the data pages of the value column
+      for (int i = 0; i < valuePages; i += KEYS_PER_PAGE) {
+        int n = (valuePages - i < KEYS_PER_PAGE) ? valuePages - i : KEYS_PER_PAGE;
+        memset(page, 0, PageFile::PAGE_SIZE);
+        memcpy(page, &firstRows[i], n * sizeof(int));
+        if ((rc = vf.write(valuePages + 1 + i / KEYS_PER_PAGE, page)) < 0) goto exit_close;
+      }
+    }
+
+    // write # rows, # data pages and the format to the first pages
+    memset(page, 0, PageFile::PAGE_SIZE);
+    memcpy(page, &rowCount, sizeof(int));
+    if (valuePages > 0) memcpy(page + sizeof(int), &valuePages, sizeof(int));
+    memcpy(page + 2*sizeof(int), &format, sizeof(int));
+    if ((rc = kf.write(0, page)) < 0) goto exit_close;
+    if (format == PLAIN && (rc = vf.write(0, page)) < 0) goto exit_close;
+  }
+
+  // the column files that were never opened fail to close silently
+  exit_close:
+  vf.close();
+  cf.close();
+  kf.close();
+  mode = 0;
+  rowCount = 0;
+  valuePages = -1;
+  keyPid = valuePid = codePid = -1;
+  firstRows.clear();
+  dictLoaded = false;
+  dict.clear();
+  codes.clear();
+  return rc;
+}
+
+RC ColumnFile::readKey(int row, int& key)
+{
+  RC rc;
+
+  if (mode != 'r' && mode != 'R') return RC_INVALID_FILE_MODE;
+  if (row < 0 || row >= rowCount) return RC_INVALID_RID;
+
+  // read the key page unless it is already in memory
+  PageId pid = 1 + row / KEYS_PER_PAGE;
+  if (pid != keyPid) {
+    if ((rc = kf.read(pid, keyPage)) < 0) return rc;
+    keyPid = pid;
+  }
+
+  memcpy(&key, keyPage + (row % KEYS_PER_PAGE) * sizeof(int), sizeof(int));
+  return 0;
+}
+
+RC ColumnFile::readValue(int row, string& value)
+{
+  RC rc;
+
+  // the value of a code is looked up in the dictionary in memory
+  if (format == DICTIONARY) {
+    int code;
+    if ((rc = readCode(row, code)) < 0) return rc;
+    value = dict[code];
+    return 0;
+  }
+
+  if (mode != 'r' && mode != 'R') return RC_INVALID_FILE_MODE;
+  if (row < 0 || row >= rowCount) return RC_INVALID_RID;
+  if (valuePages < 0 && (rc = openValues()) < 0) return rc;
+
+  // find the value page of the row, unless it is already in memory
+  int first = 0, count = 0;
+  if (valuePid > 0) {
+    first = getFirstRow(valuePage);
+    count = getValueCount(valuePage);
+  }
+  if (valuePid < 0 || row < first || row >= first + count) {
+    PageId pid;
+    if (valuePid > 0 && row == first + count) {
+      // sequential access. the row starts the next page
+      pid = valuePid + 1;
+    } else {
+      // random access. look up the page in the directory
+      if (firstRows.empty() && (rc = readDirectory()) < 0) return rc;
+      pid = std::upper_bound(firstRows.begin(), firstRows.end(), row) - firstRows.begin();
+    }
+    if ((rc = vf.read(pid, valuePage)) < 0) return rc;
+    valuePid = pid;
+    first = getFirstRow(valuePage);
+  }
+
+  // value n ends where value n-1 starts
+  int n = row - first;
+  int offset = getValueOffset(valuePage, n);
+  int end = (n == 0) ? PageFile::PAGE_SIZE : getValueOffset(valuePage, n-1);
+  value.assign(valuePage + offset, end - offset);
+  return 0;
+}
+
+RC ColumnFile::readCode(int row, int& code)
+{
+  RC rc;
+
+  if (mode != 'r' && mode != 'R') return RC_INVALID_FILE_MODE;
+  if (format != DICTIONARY) return RC_INVALID_FILE_FORMAT;
+  if (row < 0 || row >= rowCount) return RC_INVALID_RID;
+  if (!dictLoaded && (rc = openCodes()) < 0) return rc;
+
+  // read the code page unless it is already in memory
+  PageId pid = row / KEYS_PER_PAGE;
+  if (pid != codePid) {
+    if ((rc = cf.read(pid, codePage)) < 0) return rc;
+    codePid = pid;
+  }
+
+  memcpy(&code, codePage + (row % KEYS_PER_PAGE) * sizeof(int), sizeof(int));
+  if (code < 0 || code >= (int)dict.size()) return RC_INVALID_FILE_FORMAT;
+  return 0;
+}
+
+RC ColumnFile::findCode(const string& value, int& code)
+{
+  RC rc;
+
+  if (format != DICTIONARY) return RC_INVALID_FILE_FORMAT;
+  if (!dictLoaded && (rc = openCodes()) < 0) return rc;
+
+  std::map<string, int>::const_iterator it = codes.find(value);
+  code = (it == codes.end()) ? -1 : it->second;
+  return 0;
+}
+
+RC ColumnFile::appendBatch(const vector<int>& keys,
+                           const vector<string>& values,
+                           vector<RecordId>& rids)
+{
+  RC rc;
+
+  if (mode != 'w' && mode != 'W') return RC_INVALID_FILE_MODE;
+  rids.clear();
+
+  for (unsigned i = 0; i < keys.size(); i++) {
+    // store the key. write the key page when it is full
+    int slot = rowCount % KEYS_PER_PAGE;
+    if (slot == 0) {
+      keyPid = 1 + rowCount / KEYS_PER_PAGE;
+      memset(keyPage, 0, PageFile::PAGE_SIZE);
+    }
+    memcpy(keyPage + slot * sizeof(int), &keys[i], sizeof(int));
+    if (slot == KEYS_PER_PAGE - 1 && (rc = kf.write(keyPid, keyPage)) < 0) return rc;
+
+    if (format == DICTIONARY) {
+      // store the code of the value in the same slot as the key
+      if (slot == 0) {
+        codePid = keyPid - 1;
+        memset(codePage, 0, PageFile::PAGE_SIZE);
+      }
+      int code = encode(values[i]);
+      memcpy(codePage + slot * sizeof(int), &code, sizeof(int));
+      if (slot == KEYS_PER_PAGE - 1 && (rc = cf.write(codePid, codePage)) < 0) return rc;
+    } else {
+      // store the value. values longer than MAX_VALUE_LENGTH-1 are truncated
+      // as in RecordFile. if it does not fit, write the value page and
+      // start a new one
+      int length = std::min((int)values[i].size(), RecordFile::MAX_VALUE_LENGTH - 1);
+      if (valuePid < 0 || getFreeSpace(valuePage) < (int)sizeof(short) + length) {
+        if (valuePid > 0 && (rc = writeValuePage()) < 0) return rc;
+        valuePid = ++valuePages;
+        firstRows.push_back(rowCount);
+        initValuePage(valuePage, rowCount);
+      }
+      addValue(valuePage, values[i].c_str(), length);
+    }
+
+    // the location of a record is (key page, slot) of its key
+    RecordId rid;
+    rid.pid = rowCount / KEYS_PER_PAGE;
+    rid.sid = slot;
+    rids.push_back(rid);
+    rowCount++;
+  }
+
+  return 0;
+}
+
+int ColumnFile::getRowCount() const
+{
+  return rowCount;
+}
+
+int ColumnFile::getFormat() const
+{
+  return format;
+}
+
+int ColumnFile::getRow(const RecordId& rid)
+{
+  return rid.pid * KEYS_PER_PAGE + rid.sid;
+}
+
+RC ColumnFile::openValues()
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  if ((rc = vf.open(table + ".value.col", mode)) < 0) return rc;
+
+  // the first page of the value column stores # rows and # data pages
+  valuePages = 0;
+  if (vf.endPid() > 0) {
+    if ((rc = vf.read(0, page)) < 0) {
+      vf.close();
+      valuePages = -1;
+      return rc;
+    }
+    memcpy(&valuePages, page + sizeof(int), sizeof(int));
+  }
+  return 0;
+}
+
+RC ColumnFile::readDirectory()
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  firstRows.resize(valuePages);
+  for (int i = 0; i < valuePages; i += KEYS_PER_PAGE) {
+    int n = (valuePages - i < KEYS_PER_PAGE) ? valuePages - i : KEYS_PER_PAGE;
+    if ((rc = vf.read(valuePages + 1 + i / KEYS_PER_PAGE, page)) < 0) return rc;
+    memcpy(&firstRows[i], page, n * sizeof(int));
+  }
+  return 0;
+}
+
+RC ColumnFile::writeValuePage()
+{
+  return vf.write(valuePid, valuePage);
+}
+
+RC ColumnFile::openCodes()
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+  int  count;
+
+  if ((rc = cf.open(table + ".code.col", mode)) < 0) return rc;
+
+  // read the whole dictionary into memory.
+  // an empty table starts with an empty dictionary
+  dict.clear();
+  codes.clear();
+  if (rowCount > 0) {
+    if ((rc = df.open(table + ".dict.col", 'r')) < 0) return rc;
+    if ((rc = df.read(0, page)) < 0) goto exit_open;
+    memcpy(&count, page, sizeof(int));
+
+    for (PageId pid = 1; (int)dict.size() < count; pid++) {
+      if ((rc = df.read(pid, page)) < 0) goto exit_open;
+      int n;
+      memcpy(&n, page, sizeof(int));
+      const char* ptr = page + sizeof(int);
+      for (int i = 0; i < n; i++) {
+        int length = (unsigned char)*ptr++;
+        codes[string(ptr, length)] = dict.size();
+        dict.push_back(string(ptr, length));
+        ptr += length;
+      }
+    }
+    df.close();
+  }
+
+  dictLoaded = true;
+  return 0;
+
+  exit_open:
+  df.close();
+  return rc;
+}
+
+RC ColumnFile::writeDictionary()
+{
+  RC     rc;
+  char   page[PageFile::PAGE_SIZE];
+  PageId pid = 1;
+  int    n = 0;
+  int    offset = sizeof(int);
+  int    count = dict.size();
+
+  // the dictionary is rewritten as a whole
+  if ((rc = df.open(table + ".dict.col", 'w')) < 0) return rc;
+
+  memset(page, 0, PageFile::PAGE_SIZE);
+  memcpy(page, &count, sizeof(int));
+  if ((rc = df.write(0, page)) < 0) goto exit_write;
+
+  memset(page, 0, PageFile::PAGE_SIZE);
+  for (int i = 0; i < count; i++) {
+    int length = dict[i].size();
+
+    // write the page when the value does not fit
+    if (offset + 1 + length > PageFile::PAGE_SIZE) {
+      memcpy(page, &n, sizeof(int));
+      if ((rc = df.write(pid++, page)) < 0) goto exit_write;
+      memset(page, 0, PageFile::PAGE_SIZE);
+      n = 0;
+      offset = sizeof(int);
+    }
+
+    page[offset++] = length;
+    memcpy(page + offset, dict[i].c_str(), length);
+    offset += length;
+    n++;
+  }
+  if (n > 0) {
+    memcpy(page, &n, sizeof(int));
+    rc = df.write(pid, page);
+  }
+
+  exit_write:
+  df.close();
+  return rc;
+}
+
+int ColumnFile::encode(const string& value)
+{
+  // values longer than MAX_VALUE_LENGTH-1 are truncated as in RecordFile
+  string v = value.substr(0, RecordFile::MAX_VALUE_LENGTH - 1);
+
+  // a new value gets the next code
+  std::map<string, int>::const_iterator it = codes.find(v);
+  if (it != codes.end()) return it->second;
+  codes[v] = dict.size();
+  dict.push_back(v);
+  return dict.size() - 1;
+}
+
+static int getValueCount(const char* page)
+{
+  int count;
+  memcpy(&count, page, sizeof(int));
+  return count;
+}
+
+static int getFirstRow(const char* page)
+{
+  int row;
+  memcpy(&row, page + sizeof(int), sizeof(int));
+  return row;
+}
+
+static int getValueOffset(const char* page, int n)
+{
+  short offset;
+  memcpy(&offset, page + VALUE_HEADER_SIZE + n * sizeof(short), sizeof(short));
+  return offset;
+}
+
+static int getFreeSpace(const char* page)
+{
+  int count = getValueCount(page);
+  int end = (count == 0) ? PageFile::PAGE_SIZE : getValueOffset(page, count-1);
+  return end - (VALUE_HEADER_SIZE + count * sizeof(short));
+}
+
+static void addValue(char* page, const char* value, int length)
+{
+  int   count = getValueCount(page);
+  short offset = (count == 0) ? PageFile::PAGE_SIZE : getValueOffset(page, count-1);
+
+  // place the value right before the last value and record its location
+  offset -= length;
+  memcpy(page + offset, value, length);
+  memcpy(page + VALUE_HEADER_SIZE + count * sizeof(short), &offset, sizeof(short));
+
+  count++;
+  memcpy(page, &count, sizeof(int));
+}
+
+static void initValuePage(char* page, int firstRow)
+{
+  memset(page, 0, PageFile::PAGE_SIZE);
+  memcpy(page + sizeof(int), &firstRow, sizeof(int));
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef COLUMNFILE_H
+#define COLUMNFILE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include "PageFile.h"
+#include "RecordFile.h"
+
+/**
+ * read/write a table stored column by column.
+ * the keys are stored in table.key.col and the values in table.value.col,
+ * so that a query reads only the columns it references.
+ * the records of a column table are identified by their row number.
+ * in the DICTIONARY format, every distinct value is stored once in
+ * table.dict.col and the rows store its code in table.code.col.
+ */
+class ColumnFile {
+ public:
+
+  // number of keys per page of the key column
+  static const int KEYS_PER_PAGE = PageFile::PAGE_SIZE / sizeof(int);
+
+  // the formats of the value column
+  static const int PLAIN = 0;       // values stored as they are
+  static const int DICTIONARY = 1;  // values stored as dictionary codes
+
+  ColumnFile();
+
+  /**
+   * open the column files of a table in read or write mode.
+   * when opened in 'w' mode, if the files do not exist, they are created.
+   * @param table[IN] the name of the table
+   * @param mode[IN] 'r' for read, 'w' for write
+   * @param format[IN] the format of the value column of an empty table
+   * opened in 'w' mode. RC_INVALID_FILE_FORMAT is returned if the table
+   * has rows in another format. ignored in 'r' mode
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& table, char mode, int format = PLAIN);
+
+  /**
+   * close the column files.
+   * in 'w' mode, the pages still held in memory are written first.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * read the key of a row.
+   * consecutive rows are read from the page already in memory.
+   * @param row[IN] the row number. the first row is 0
+   * @param key[OUT] the key of the row
+   * @return error code. 0 if no error
+   */
+  RC readKey(int row, int& key);
+
+  /**
+   * read the value of a row. the value column is opened on first use,
+   * so queries that do not need values never read it.
+   * consecutive rows are read from the page already in memory.
+   * @param row[IN] the row number. the first row is 0
+   * @param value[OUT] the value of the row
+   * @return error code. 0 if no error
+   */
+  RC readValue(int row, std::string& value);
+
+  /**
+   * read the dictionary code of the value of a row.
+   * the table must be in the DICTIONARY format.
+   * @param row[IN] the row number. the first row is 0
+   * @param code[OUT] the code of the value of the row
+   * @return error code. 0 if no error
+   */
+  RC readCode(int row, int& code);
+
+  /**
+   * look up the dictionary code of a value, so that equality conditions
+   * on the value can be checked on codes without reading the values.
+   * the table must be in the DICTIONARY format.
+   * @param value[IN] the value to look up
+   * @param code[OUT] the code of the value. -1 if no row has the value
+   * @return error code. 0 if no error
+   */
+  RC findCode(const std::string& value, int& code);
+
+  /**
+   * append a batch of records at the end of the table.
+   * @param keys[IN] the record keys
+   * @param values[IN] the record values. values[i] is the value of keys[i]
+   * @param rids[OUT] the locations of the stored records
+   * @return error code. 0 if no error
+   */
+  RC appendBatch(const std::vector<int>& keys,
+                 const std::vector<std::string>& values,
+                 std::vector<RecordId>& rids);
+
+  /**
+   * @return # rows in the table
+   */
+  int getRowCount() const;
+
+  /**
+   * @return the format of the value column. PLAIN or DICTIONARY
+   */
+  int getFormat() const;
+
+  /**
+   * convert the location of a record returned by appendBatch()
+   * (and stored in the index) to its row number.
+   * @param rid[IN] the location of the record
+   * @return the row number
+   */
+  static int getRow(const RecordId& rid);
+
+ private:
+  RC openValues();
+  RC readDirectory();
+  RC writeValuePage();
+  RC openCodes();
+  RC writeDictionary();
+  int encode(const std::string& value);
+
+  std::string table;     // the name of the table
+  char        mode;      // the mode the table is opened in
+  int         format;    // the format of the value column
+  PageFile    kf;        // the key column
+  PageFile    vf;        // the value column
+  PageFile    cf;        // the code column of the DICTIONARY format
+  PageFile    df;        // the dictionary of the DICTIONARY format
+  int         rowCount;  // # rows in the table
+  int         valuePages;// # data pages in the value column. -1 if not open
+  std::vector<int> firstRows; // the first row of every value page
+
+  bool        dictLoaded;           // whether the dictionary is in memory
+  std::vector<std::string> dict;    // the value of every code
+  std::map<std::string, int> codes; // the code of every value
+
+  PageId keyPid;         // the key page in keyPage
+  PageId valuePid;       // the value page in valuePage
+  PageId codePid;        // the code page in codePage
+  char   keyPage[PageFile::PAGE_SIZE];
+  char   valuePage[PageFile::PAGE_SIZE];
+  char   codePage[PageFile::PAGE_SIZE];
+};
+
+#endif // COLUMNFILE_H
@@ -0,0 +1,1511 @@
+/**
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include "Operator.h"
+
+using std::string;
+using std::vector;
+using std::pair;
+using std::make_pair;
+
+// count the page reads of fetching the tuples at the rids in the
+// given order through an LRU cache of PageFile::CACHE_COUNT pages
+static int countMisses(const vector<IndexEntry>& entries)
+{
+  vector<PageId> cache;   // the cached pages, the most recently used last
+  int misses = 0;
+
+  for (unsigned i = 0; i < entries.size(); i++) {
+    PageId pid = entries[i].rid.pid;
+    vector<PageId>::iterator it = find(cache.begin(), cache.end(), pid);
+    if (it != cache.end()) {
+      cache.erase(it);
+    } else {
+      misses++;
+      if ((int)cache.size() == PageFile::CACHE_COUNT) cache.erase(cache.begin());
+    }
+    cache.push_back(pid);
+  }
+  return misses;
+}
+
+// whether fetching the tuples at the rids of the index entries in key
+// order reads more pages than there are distinct pages: a page holding
+// scattered keys is read again whenever it has left the cache
+static bool rereadsPages(const vector<IndexEntry>& entries)
+{
+  vector<PageId> pids;
+
+  for (unsigned i = 0; i < entries.size(); i++) pids.push_back(entries[i].rid.pid);
+  sort(pids.begin(), pids.end());
+  int pages = unique(pids.begin(), pids.end()) - pids.begin();
+  return pages < countMisses(entries);
+}
+
+// read the values of the tuples at the rids of the index entries in rid
+// order, so that every page is read once. values[i] is the value of entries[i]
+static RC fetchSorted(const RecordFile& rf, const vector<IndexEntry>& entries, vector<string>& values)
+{
+  RC  rc;
+  int key;
+  vector<pair<RecordId, int> > order;  // (rid, position in entries)
+
+  values.assign(entries.size(), string());
+  for (unsigned i = 0; i < entries.size(); i++) {
+    order.push_back(make_pair(entries[i].rid, (int)i));
+  }
+  sort(order.begin(), order.end());
+
+  for (unsigned i = 0; i < order.size(); i++) {
+    if ((rc = rf.read(order[i].first, key, values[order[i].second])) < 0) return rc;
+  }
+  return 0;
+}
+
+
+// compare two values that are not terminated by zero as strcmp() does
+static int compareValues(const char* v1, int length1, const char* v2, int length2)
+{
+  int diff = memcmp(v1, v2, length1 < length2 ? length1 : length2);
+  return diff != 0 ? diff : length1 - length2;
+}
+
+// add up the selected keys of a batch
+static long long sumKeys(const TupleBatch& batch)
+{
+  const int*   keys = batch.keys;
+  const short* sel = batch.sel;
+  long long    sum = 0;
+
+  for (int j = 0; j < batch.selCount; j++) sum += keys[sel[j]];
+  return sum;
+}
+
+// narrow [minKey, maxKey] to the selected keys of a batch.
+// the comparisons select a value instead of branching
+static void rangeKeys(const TupleBatch& batch, int& minKey, int& maxKey)
+{
+  const int*   keys = batch.keys;
+  const short* sel = batch.sel;
+  int lo = minKey, hi = maxKey;
+
+  for (int j = 0; j < batch.selCount; j++) {
+    int key = keys[sel[j]];
+    lo = key < lo ? key : lo;
+    hi = key > hi ? key : hi;
+  }
+  minKey = lo;
+  maxKey = hi;
+}
+
+// print an aggregate function of the keys of count tuples into buf:
+// count(*), or their sum, average, smallest or largest key
+static void formatKeys(int function, long long count, long long sum, int minKey, int maxKey, char* buf)
+{
+  switch (function) {
+  case SqlEngine::SUM_KEY: sprintf(buf, "%lld", sum); break;
+  case SqlEngine::AVG_KEY: sprintf(buf, "%.2f", (double)sum / count); break;
+  case SqlEngine::MIN_KEY: sprintf(buf, "%d", minKey); break;
+  case SqlEngine::MAX_KEY: sprintf(buf, "%d", maxKey); break;
+  default:                 sprintf(buf, "%lld", count); break;
+  }
+}
+
+// mix the bits of a 32-bit value, so that every bit of the result
+// depends on every bit of h (the finalizer of MurmurHash3)
+static unsigned mixBits(unsigned h)
+{
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+// hash a value that is not terminated by zero (FNV-1a)
+static unsigned hashValue(const char* value, int length)
+{
+  unsigned h = 2166136261u;
+  for (int i = 0; i < length; i++) {
+    h ^= (unsigned char)value[i];
+    h *= 16777619;
+  }
+  return mixBits(h);
+}
+
+// the order of two tuples: negative if the first one comes first.
+// order is the attribute to order by, negated for descending order
+static int compareTuples(int order, int key1, const char* value1, int length1,
+                         int key2, const char* value2, int length2)
+{
+  int diff;
+
+  if (order == 1 || order == -1) diff = key1 < key2 ? -1 : (key1 > key2 ? 1 : 0);
+  else diff = compareValues(value1, length1, value2, length2);
+  return order < 0 ? -diff : diff;
+}
+
+// remove a record file and the files that come with it
+static void removeRecordFile(const string& name)
+{
+  remove(name.c_str());
+  remove((name + ".zm").c_str());
+  remove((name + ".ovf").c_str());
+  remove((name + ".free").c_str());
+}
+
+// create a temporary record file named prefix.n.tmp
+// for the n-th file of an operator
+static RC createTempFile(const string& prefix, int& n, string& name, RecordFile*& rf)
+{
+  RC   rc;
+  char suffix[16];
+
+  sprintf(suffix, ".%d.tmp", n++);
+  name = prefix + suffix;
+  removeRecordFile(name);
+  rf = new RecordFile;
+  if ((rc = rf->open(name, 'w')) < 0) {
+    delete rf;
+    rf = NULL;
+  }
+  return rc;
+}
+
+// no condition, to scan every tuple of a temporary file
+static const vector<SelCond> noCond;
+static const Predicate allTuples(noCond);
+
+//
+// Operator
+//
+
+RC Operator::nextBatch(const TupleBatch*& batch)
+{
+  RC    rc = 0;
+  Tuple tuple;
+
+  if (out == NULL) out = new TupleBatch;
+  out->clear();
+  while (out->count < TupleBatch::CAPACITY && (rc = next(tuple)) == 0) {
+    int i = out->count++;
+    out->keys[i] = tuple.key;
+    out->rids[i] = tuple.rid;
+    out->lengths[i] = tuple.length;
+    out->values[i] = tuple.value;
+    if (tuple.value != NULL) out->longValues.push_back(string(tuple.value, tuple.length));
+  }
+  if (rc < 0 && rc != RC_END_OF_TREE) return rc;
+  if (out->count == 0) return RC_END_OF_TREE;
+
+  // the copies of the values have their final place only now
+  for (int i = 0, k = 0; i < out->count; i++) {
+    if (out->values[i] != NULL) out->values[i] = out->longValues[k++].data();
+  }
+  out->selectAll();
+  batch = out;
+  return 0;
+}
+
+
+//
+// TableScan
+//
+
+TableScan::TableScan(RecordFile& rf, const Predicate& pred, bool needValues)
+  : rf(rf), pred(pred), needValues(needValues), sc(rf)
+{
+  batch = NULL;
+  pos = 0;
+}
+
+TableScan::~TableScan()
+{
+  delete batch;
+}
+
+RC TableScan::open()
+{
+  sc = RecordFile::Scanner(rf);
+  if (batch == NULL) batch = new TupleBatch;
+  batch->clear();
+  pos = 0;
+  return 0;
+}
+
+RC TableScan::next(Tuple& tuple)
+{
+  RC rc;
+
+  // a batch may come back empty before the end of the table
+  while (pos >= batch->selCount) {
+    if (sc.atEnd()) return RC_END_OF_TREE;
+    if ((rc = nextBatch()) < 0) return rc;
+  }
+
+  int i = batch->sel[pos++];
+  tuple.key = batch->keys[i];
+  tuple.value = needValues ? batch->values[i] : NULL;
+  tuple.length = needValues ? batch->lengths[i] : 0;
+  tuple.rid = batch->rids[i];
+  return 0;
+}
+
+RC TableScan::nextBatch(const TupleBatch*& result)
+{
+  RC rc;
+
+  while (pos >= batch->selCount) {
+    if (sc.atEnd()) return RC_END_OF_TREE;
+    if ((rc = nextBatch()) < 0) return rc;
+  }
+
+  // the batch is returned as it is, without the tuples already
+  // returned by next()
+  if (pos > 0) {
+    memmove(batch->sel, batch->sel + pos, (batch->selCount - pos) * sizeof(short));
+    batch->selCount -= pos;
+  }
+  pos = batch->selCount;
+  result = batch;
+  return 0;
+}
+
+RC TableScan::close()
+{
+  delete batch;
+  batch = NULL;
+  return 0;
+}
+
+// read the next pages of the table into the batch, skipping the pages
+// that the zone map rules out, and select the tuples of the batch that
+// meet the conditions. the keys are filtered first, and the values are
+// read and filtered only for the tuples that pass
+RC TableScan::nextBatch()
+{
+  RC rc;
+
+  batch->clear();
+  pos = 0;
+  for (; !sc.atEnd() && batch->hasRoom(); sc.nextPage()) {
+    int minKey, maxKey;
+    if (pred.hasKeyCond() && rf.getZone(sc.getPid(), minKey, maxKey) == 0
+        && !pred.matchZone(minKey, maxKey)) {
+      continue;
+    }
+    if ((rc = sc.readPage(*batch)) < 0) return rc;
+  }
+
+  pred.filterKeys(*batch);
+  if (needValues || pred.hasValueCond()) {
+    if ((rc = rf.readLongValues(*batch)) < 0) return rc;
+    pred.filterValues(*batch);
+  }
+  return 0;
+}
+
+//
+// IndexScan
+//
+
+IndexScan::IndexScan(BTreeIndex& tree, const RecordFile* rf, const Predicate& pred)
+  : tree(tree), rf(rf), pred(pred)
+{
+  sorted = false;
+  done = true;
+  pos = 0;
+}
+
+RC IndexScan::open()
+{
+  RC rc;
+
+  entries.clear();
+  values.clear();
+  sorted = false;
+  done = false;
+  pos = 0;
+
+  // read forward from the smallest key allowed by the conditions.
+  // an empty index cannot be located in
+  if (pred.isEmpty() || tree.locate(pred.getLowKey(), cursor) < 0) {
+    done = true;
+    return 0;
+  }
+
+  // the first LOOKAHEAD entries decide the order of the fetches. only
+  // if key order reads pages again are all the entries read and their
+  // tuples fetched in rid order. otherwise the scan goes on in next()
+  if (rf == NULL) return 0;
+  readEntries(LOOKAHEAD);
+  if (!rereadsPages(entries)) return 0;
+  sorted = true;
+  readEntries(UINT_MAX);
+  return fetchSorted(*rf, entries, values);
+}
+
+RC IndexScan::next(Tuple& tuple)
+{
+  RC  rc;
+  int key;
+
+  // the entries read ahead go first. the others are read one at a time
+  if (pos >= entries.size()) {
+    entries.clear();
+    pos = 0;
+    if (!sorted) readEntries(1);
+    if (entries.empty()) return RC_END_OF_TREE;
+  }
+
+  const IndexEntry& entry = entries[pos++];
+  tuple.key = entry.key;
+  tuple.rid = entry.rid;
+  if (rf == NULL) {
+    tuple.value = NULL;
+    tuple.length = 0;
+    return 0;
+  }
+  if (sorted) {
+    tuple.value = values[pos - 1].data();
+    tuple.length = values[pos - 1].size();
+    return 0;
+  }
+  if ((rc = rf->read(entry.rid, key, value)) < 0) return rc;
+  tuple.value = value.data();
+  tuple.length = value.size();
+  return 0;
+}
+
+RC IndexScan::close()
+{
+  entries.clear();
+  values.clear();
+  done = true;
+  return 0;
+}
+
+// append the entries that meet the conditions to the entries read ahead,
+// until there are count of them. the keys come in order, so no key past
+// the largest one allowed by the conditions can match
+void IndexScan::readEntries(unsigned count)
+{
+  IndexEntry entry;
+
+  while (!done && entries.size() < count) {
+    if (tree.readForward(cursor, entry.key, entry.rid) != 0 || entry.key > pred.getHighKey()) {
+      done = true;
+    } else if (pred.matchKey(entry.key)) {
+      entries.push_back(entry);
+    }
+  }
+}
+
+//
+// KeyProbe
+//
+
+KeyProbe::KeyProbe(BTreeIndex& tree, const Predicate& pred, bool last)
+  : tree(tree), pred(pred), last(last)
+{
+  found = false;
+  key = 0;
+  done = true;
+}
+
+RC KeyProbe::open()
+{
+  RC          rc;
+  IndexCursor cursor;
+  RecordId    rid;
+  int         k;
+
+  found = false;
+  done = false;
+  if (pred.isEmpty()) return 0;
+
+  // the largest key of the index usually meets the conditions,
+  // for example when there is none
+  if (last) {
+    if ((rc = tree.readLastKey(k)) == RC_NO_SUCH_RECORD) return 0;
+    if (rc < 0) return rc;
+    if (pred.matchKey(k)) {
+      key = k;
+      found = true;
+      return 0;
+    }
+  }
+
+  // otherwise read forward from the smallest key allowed by the conditions
+  if (tree.locate(pred.getLowKey(), cursor) < 0) return 0;
+  while (tree.readForward(cursor, k, rid) == 0 && k <= pred.getHighKey()) {
+    if (!pred.matchKey(k)) continue;
+    key = k;
+    found = true;
+    if (!last) break;
+  }
+  return 0;
+}
+
+RC KeyProbe::next(Tuple& tuple)
+{
+  if (done || !found) return RC_END_OF_TREE;
+  done = true;
+
+  tuple.key = key;
+  tuple.value = NULL;
+  tuple.length = 0;
+  tuple.rid.pid = tuple.rid.sid = -1;
+  return 0;
+}
+
+RC KeyProbe::close()
+{
+  done = true;
+  return 0;
+}
+
+//
+// SSTableScan
+//
+
+SSTableScan::SSTableScan(SSTable& sst, const Predicate& pred)
+  : sst(sst), pred(pred)
+{
+  done = true;
+}
+
+RC SSTableScan::open()
+{
+  RC rc;
+
+  // the scan starts at the lower end of the key range of the conditions
+  done = pred.isEmpty();
+  if (!done && (rc = sst.locate(pred.getLowKey(), cursor)) < 0) return rc;
+  return 0;
+}
+
+RC SSTableScan::next(Tuple& tuple)
+{
+  while (!done && sst.readForward(cursor, tuple.key, tuple.value, tuple.length) == 0) {
+    // and stops at the first key past its upper end
+    if (tuple.key > pred.getHighKey()) break;
+    if (!pred.matchKey(tuple.key)) continue;
+    tuple.rid.pid = -1;
+    tuple.rid.sid = -1;
+    return 0;
+  }
+  done = true;
+  return RC_END_OF_TREE;
+}
+
+RC SSTableScan::close()
+{
+  done = true;
+  return 0;
+}
+
+//
+// ColumnScan
+//
+
+ColumnScan::ColumnScan(ColumnFile& cf, BTreeIndex* tree, const vector<SelCond>& cond,
+                       const Predicate& pred, bool needValues)
+  : cf(cf), tree(tree), cond(cond), pred(pred), needValues(needValues)
+{
+  row = 0;
+  done = true;
+}
+
+RC ColumnScan::open()
+{
+  RC rc;
+
+  row = 0;
+  done = pred.isEmpty();
+  codes.clear();
+  if (done) return 0;
+
+  // with a dictionary, equality conditions on the value are checked on
+  // codes. a value missing from the dictionary matches no row
+  if (cf.getFormat() == ColumnFile::DICTIONARY) {
+    codes.resize(cond.size(), -1);
+    for (unsigned i = 0; i < cond.size(); i++) {
+      if (cond[i].attr != 2) continue;
+      if (cond[i].comp != SelCond::EQ && cond[i].comp != SelCond::NE) {
+        codes.clear();
+        break;
+      }
+      if ((rc = cf.findCode(cond[i].value, codes[i])) < 0) return rc;
+      if (cond[i].comp == SelCond::EQ && codes[i] < 0) {
+        done = true;
+        return 0;
+      }
+    }
+  }
+
+  // start from the smallest key allowed by the conditions
+  if (tree != NULL && tree->locate(pred.getLowKey(), cursor) < 0) done = true;
+  return 0;
+}
+
+RC ColumnScan::next(Tuple& tuple)
+{
+  RC       rc;
+  RecordId rid;
+  bool     match;
+
+  while (!done) {
+    int r;
+    if (tree != NULL) {
+      // stop at the first key beyond the largest one allowed
+      if (tree->readForward(cursor, tuple.key, rid) < 0 || tuple.key > pred.getHighKey()) break;
+      r = ColumnFile::getRow(rid);
+    } else {
+      // scan the key column and read the value column only when needed
+      if (row >= cf.getRowCount()) break;
+      r = row++;
+      if ((rc = cf.readKey(r, tuple.key)) < 0) return rc;
+    }
+    if (!pred.matchKey(tuple.key)) continue;
+    if ((rc = matchRow(r, match)) < 0) return rc;
+    if (!match) continue;
+
+    tuple.value = needValues ? value.data() : NULL;
+    tuple.length = needValues ? value.size() : 0;
+    tuple.rid.pid = -1;
+    tuple.rid.sid = r;
+    return 0;
+  }
+  done = true;
+  return RC_END_OF_TREE;
+}
+
+RC ColumnScan::close()
+{
+  done = true;
+  codes.clear();
+  return 0;
+}
+
+// check the conditions on the value of a row and read the value if it is
+// returned. when codes is not empty, it holds the dictionary codes of the
+// values in the (equality) conditions, which are then checked on the code
+// of the row without reading the value
+RC ColumnScan::matchRow(int row, bool& match)
+{
+  RC   rc;
+  bool valueRead = false;
+
+  match = true;
+  if (!codes.empty()) {
+    for (unsigned i = 0; i < cond.size() && match; i++) {
+      if (cond[i].attr != 2) continue;
+      int code;
+      if ((rc = cf.readCode(row, code)) < 0) return rc;
+      if (cond[i].comp == SelCond::EQ) match = (code == codes[i]);
+      else match = (code != codes[i]);
+    }
+  } else if (pred.hasValueCond()) {
+    if ((rc = cf.readValue(row, value)) < 0) return rc;
+    valueRead = true;
+    match = pred.matchValue(value.data(), value.size());
+  }
+
+  // materialize the value only for the rows that are returned
+  if (match && !valueRead && needValues) {
+    if ((rc = cf.readValue(row, value)) < 0) return rc;
+  }
+  return 0;
+}
+
+//
+// Filter
+//
+
+Filter::Filter(Operator* input, const Predicate& pred)
+  : input(input), pred(pred)
+{
+}
+
+Filter::~Filter()
+{
+  delete input;
+}
+
+RC Filter::open()
+{
+  return input->open();
+}
+
+RC Filter::next(Tuple& tuple)
+{
+  RC rc;
+
+  while ((rc = input->next(tuple)) == 0) {
+    if (!pred.matchKey(tuple.key)) continue;
+    if (pred.hasValueCond() && !pred.matchValue(tuple.value, tuple.length)) continue;
+    return 0;
+  }
+  return rc;
+}
+
+RC Filter::close()
+{
+  return input->close();
+}
+
+//
+// Project
+//
+
+Project::Project(Operator* input, int attr)
+  : input(input), attr(attr)
+{
+}
+
+Project::~Project()
+{
+  delete input;
+}
+
+RC Project::open()
+{
+  return input->open();
+}
+
+RC Project::next(Tuple& tuple)
+{
+  RC rc;
+
+  if ((rc = input->next(tuple)) < 0) return rc;
+  if (attr == 1) {
+    tuple.value = NULL;
+    tuple.length = 0;
+  }
+  return 0;
+}
+
+RC Project::close()
+{
+  return input->close();
+}
+
+//
+// Aggregate
+//
+
+Aggregate::Aggregate(Operator* input, int function)
+  : input(input), function(function)
+{
+  count = sum = 0;
+  minKey = maxKey = 0;
+  done = true;
+}
+
+Aggregate::~Aggregate()
+{
+  delete input;
+}
+
+RC Aggregate::open()
+{
+  RC                rc;
+  const TupleBatch* batch;
+  char              buf[32];
+
+  // the input is used up here, so that an error shows up before any output
+  count = sum = 0;
+  minKey = INT_MAX;
+  maxKey = INT_MIN;
+  minValue.clear();
+  maxValue.clear();
+  keys.clear();
+  values.clear();
+  done = false;
+  if ((rc = input->open()) < 0) return rc;
+  while ((rc = input->nextBatch(batch)) == 0) add(*batch);
+  if (rc != RC_END_OF_TREE) return rc;
+
+  // the functions but COUNT are NULL over no tuples
+  result = "NULL";
+  switch (function) {
+  case SqlEngine::MIN_VALUE:
+    if (count > 0) result = minValue;
+    break;
+  case SqlEngine::MAX_VALUE:
+    if (count > 0) result = maxValue;
+    break;
+  case SqlEngine::COUNT_DISTINCT_KEY:
+    sprintf(buf, "%d", (int)keys.size());
+    result = buf;
+    break;
+  case SqlEngine::COUNT_DISTINCT_VALUE:
+    sprintf(buf, "%d", (int)values.size());
+    result = buf;
+    break;
+  default:
+    if (count == 0 && function != 4) break;
+    formatKeys(function, count, sum, minKey, maxKey, buf);
+    result = buf;
+    break;
+  }
+  return 0;
+}
+
+// fold the selected tuples of a batch into the aggregate
+void Aggregate::add(const TupleBatch& batch)
+{
+  const short* sel = batch.sel;
+  int n = batch.selCount;
+
+  switch (function) {
+  case SqlEngine::SUM_KEY:
+  case SqlEngine::AVG_KEY:
+    sum += sumKeys(batch);
+    break;
+  case SqlEngine::MIN_KEY:
+  case SqlEngine::MAX_KEY:
+    rangeKeys(batch, minKey, maxKey);
+    break;
+  case SqlEngine::MIN_VALUE:
+  case SqlEngine::MAX_VALUE:
+    for (int j = 0; j < n; j++) {
+      const char* value = batch.values[sel[j]];
+      int length = batch.lengths[sel[j]];
+      if (count + j == 0 || compareValues(value, length, minValue.data(), minValue.size()) < 0) {
+        minValue.assign(value, length);
+      }
+      if (count + j == 0 || compareValues(value, length, maxValue.data(), maxValue.size()) > 0) {
+        maxValue.assign(value, length);
+      }
+    }
+    break;
+  case SqlEngine::COUNT_DISTINCT_KEY:
+    for (int j = 0; j < n; j++) keys.insert(batch.keys[sel[j]]);
+    break;
+  case SqlEngine::COUNT_DISTINCT_VALUE:
+    for (int j = 0; j < n; j++) values.insert(string(batch.values[sel[j]], batch.lengths[sel[j]]));
+    break;
+  }
+  count += n;
+}
+
+RC Aggregate::next(Tuple& tuple)
+{
+  if (done) return RC_END_OF_TREE;
+  done = true;
+
+  tuple.key = 0;
+  tuple.value = result.data();
+  tuple.length = result.size();
+  tuple.rid.pid = tuple.rid.sid = -1;
+  return 0;
+}
+
+RC Aggregate::close()
+{
+  done = true;
+  keys.clear();
+  values.clear();
+  return input->close();
+}
+
+//
+// Limit
+//
+
+Limit::Limit(Operator* input, int n)
+  : input(input), n(n)
+{
+  returned = 0;
+}
+
+Limit::~Limit()
+{
+  delete input;
+}
+
+RC Limit::open()
+{
+  returned = 0;
+  return input->open();
+}
+
+RC Limit::next(Tuple& tuple)
+{
+  RC rc;
+
+  // the input is not read past the last tuple returned
+  if (returned >= n) return RC_END_OF_TREE;
+  if ((rc = input->next(tuple)) < 0) return rc;
+  returned++;
+  return 0;
+}
+
+RC Limit::close()
+{
+  return input->close();
+}
+
+//
+// Sort
+//
+
+Sort::Sort(Operator* input, int order, int limit, bool needValues, const string& spillName)
+  : input(input), order(order), limit(limit), spillName(spillName)
+{
+  // the values to order by are kept like the values returned
+  this->needValues = needValues || order == 2 || order == -2;
+  useHeap = passThrough = false;
+  bytes = 0;
+  seq = 0;
+  merged = 0;
+  last = -1;
+  fileCount = 0;
+  pos = 0;
+}
+
+Sort::~Sort()
+{
+  delete input;
+}
+
+bool Sort::fitsHeap(int limit)
+{
+  // a heap of limit tuples of the longest value stored in a page fits in memory
+  return limit >= 0 && limit * (sizeof(Entry) + RecordFile::MAX_VALUE_LENGTH) <= (unsigned)MEMORY_BUDGET;
+}
+
+RC Sort::open()
+{
+  RC                rc;
+  const TupleBatch* batch;
+
+  entries.clear();
+  bytes = 0;
+  seq = 0;
+  pos = 0;
+  if ((rc = input->open()) < 0) return rc;
+
+  // an input in key order is returned as it is
+  passThrough = order == 1 && input->isOrdered();
+  if (passThrough) return 0;
+
+  useHeap = fitsHeap(limit);
+
+  while ((rc = input->nextBatch(batch)) == 0) {
+    for (int j = 0; j < batch->selCount; j++) {
+      int i = batch->sel[j];
+      const char* value = needValues ? batch->values[i] : NULL;
+      if ((rc = add(batch->keys[i], value, needValues ? batch->lengths[i] : 0)) < 0) return rc;
+    }
+  }
+  if (rc != RC_END_OF_TREE) return rc;
+
+  if (useHeap) {
+    sort_heap(entries.begin(), entries.end(), EntryLess(order, true));
+    return 0;
+  }
+  if (runs.empty()) {
+    stable_sort(entries.begin(), entries.end(), EntryLess(order, false));
+    return 0;
+  }
+
+  // the runs are merged until MERGE_FAN_IN runs are left for next() to merge
+  if ((rc = writeRun()) < 0) return rc;
+  while (runs.size() > (unsigned)MERGE_FAN_IN) {
+    if ((rc = mergeRuns(MERGE_FAN_IN)) < 0) return rc;
+  }
+  return openRuns(runs.size());
+}
+
+RC Sort::next(Tuple& tuple)
+{
+  RC rc;
+
+  if (limit >= 0 && (int)pos >= limit) return RC_END_OF_TREE;
+
+  if (passThrough) {
+    if ((rc = input->next(tuple)) < 0) return rc;
+  } else if (merged > 0) {
+    if ((rc = nextMerged(tuple)) < 0) return rc;
+  } else {
+    if (pos >= entries.size()) return RC_END_OF_TREE;
+    tuple.key = entries[pos].key;
+    tuple.value = entries[pos].value.data();
+    tuple.length = entries[pos].value.size();
+    tuple.rid.pid = tuple.rid.sid = -1;
+  }
+  pos++;
+  return 0;
+}
+
+RC Sort::close()
+{
+  closeRuns();
+  for (unsigned i = 0; i < runs.size(); i++) removeRecordFile(runs[i].name);
+  runs.clear();
+  entries.clear();
+  return input->close();
+}
+
+bool Sort::EntryLess::operator()(const Entry& e1, const Entry& e2) const
+{
+  int diff = compareTuples(order, e1.key, e1.value.data(), e1.value.size(),
+                           e2.key, e2.value.data(), e2.value.size());
+  return diff < 0 || (diff == 0 && bySeq && e1.seq < e2.seq);
+}
+
+// add an input tuple to the tuples in memory. with a heap, the last of
+// the tuples kept is on top, and a new tuple replaces it if it comes
+// first. otherwise the tuples are written out as a run when they take
+// more than MEMORY_BUDGET bytes
+RC Sort::add(int key, const char* value, int length)
+{
+  EntryLess less(order, true);
+
+  if (useHeap && (int)entries.size() >= limit) {
+    const Entry& top = entries.front();
+    if (limit == 0 || compareTuples(order, key, value, length, top.key, top.value.data(), top.value.size()) >= 0) {
+      seq++;
+      return 0;
+    }
+    pop_heap(entries.begin(), entries.end(), less);
+    entries.pop_back();
+  }
+
+  entries.push_back(Entry());
+  Entry& e = entries.back();
+  e.key = key;
+  e.seq = seq++;
+  if (value != NULL) e.value.assign(value, length);
+  if (useHeap) {
+    push_heap(entries.begin(), entries.end(), less);
+    return 0;
+  }
+
+  bytes += sizeof(Entry) + length;
+  return bytes > MEMORY_BUDGET ? writeRun() : 0;
+}
+
+// create a run file to write
+RC Sort::createRun(Run& run)
+{
+  run.scan = NULL;
+  run.done = true;
+  return createTempFile(spillName, fileCount, run.name, run.rf);
+}
+
+// sort the tuples in memory into a new run at the end of runs
+RC Sort::writeRun()
+{
+  RC               rc;
+  Run              run;
+  vector<int>      keys;
+  vector<string>   values;
+  vector<RecordId> rids;
+
+  stable_sort(entries.begin(), entries.end(), EntryLess(order, false));
+  keys.resize(entries.size());
+  values.resize(entries.size());
+  for (unsigned i = 0; i < entries.size(); i++) {
+    keys[i] = entries[i].key;
+    values[i].swap(entries[i].value);
+  }
+  entries.clear();
+  bytes = 0;
+
+  if ((rc = createRun(run)) < 0) return rc;
+  rc = run.rf->appendBatch(keys, values, rids);
+  if (run.rf->close() < 0 && rc == 0) rc = RC_FILE_CLOSE_FAILED;
+  delete run.rf;
+  run.rf = NULL;
+  runs.push_back(run);
+  return rc;
+}
+
+// merge the first count runs into a new run at the end of runs
+RC Sort::mergeRuns(unsigned count)
+{
+  RC               rc;
+  Run              out;
+  Tuple            tuple;
+  vector<int>      keys;
+  vector<string>   values;
+  vector<RecordId> rids;
+
+  if ((rc = openRuns(count)) < 0 || (rc = createRun(out)) < 0) {
+    closeRuns();
+    return rc;
+  }
+
+  // the merged tuples are appended a page at a time
+  while ((rc = nextMerged(tuple)) == 0) {
+    keys.push_back(tuple.key);
+    values.push_back(string(tuple.value, tuple.length));
+    if ((int)keys.size() < RecordFile::RECORDS_PER_PAGE) continue;
+    if ((rc = out.rf->appendBatch(keys, values, rids)) < 0) break;
+    keys.clear();
+    values.clear();
+  }
+  if (rc == RC_END_OF_TREE) rc = keys.empty() ? 0 : out.rf->appendBatch(keys, values, rids);
+  if (out.rf->close() < 0 && rc == 0) rc = RC_FILE_CLOSE_FAILED;
+  delete out.rf;
+  out.rf = NULL;
+
+  closeRuns();
+  runs.push_back(out);
+  return rc;
+}
+
+// open the first count runs to merge, and read the first tuple of each
+RC Sort::openRuns(unsigned count)
+{
+  RC rc;
+
+  merged = count;
+  last = -1;
+  for (unsigned i = 0; i < count; i++) {
+    runs[i].rf = new RecordFile;
+    runs[i].scan = NULL;
+    runs[i].done = true;
+    if ((rc = runs[i].rf->open(runs[i].name, 'r')) < 0) return rc;
+    runs[i].scan = new TableScan(*runs[i].rf, allTuples, needValues);
+    if ((rc = runs[i].scan->open()) < 0 || (rc = advance(runs[i])) < 0) return rc;
+  }
+  return 0;
+}
+
+// return the first of the next tuples of the runs being merged. the
+// fan-in is small enough for the runs to be compared one by one, and
+// the first run wins a tie, so that equal tuples keep their input order
+RC Sort::nextMerged(Tuple& tuple)
+{
+  RC rc;
+
+  // the tuple returned last stays valid until now,
+  // so its run moves on only now
+  if (last >= 0 && (rc = advance(runs[last])) < 0) return rc;
+
+  last = -1;
+  for (unsigned r = 0; r < merged; r++) {
+    if (runs[r].done) continue;
+    const Tuple& t = runs[r].tuple;
+    const Tuple& first = runs[last < 0 ? r : last].tuple;
+    if (last < 0 || compareTuples(order, t.key, t.value, t.length, first.key, first.value, first.length) < 0) {
+      last = r;
+    }
+  }
+  if (last < 0) return RC_END_OF_TREE;
+  tuple = runs[last].tuple;
+  return 0;
+}
+
+// read the next tuple of a run being merged
+RC Sort::advance(Run& run)
+{
+  RC rc = run.scan->next(run.tuple);
+
+  run.done = rc < 0;
+  return rc == RC_END_OF_TREE ? 0 : rc;
+}
+
+// close the runs being merged and remove them
+void Sort::closeRuns()
+{
+  for (unsigned i = 0; i < merged; i++) {
+    if (runs[i].scan != NULL) {
+      runs[i].scan->close();
+      delete runs[i].scan;
+    }
+    if (runs[i].rf != NULL) {
+      runs[i].rf->close();
+      delete runs[i].rf;
+    }
+    removeRecordFile(runs[i].name);
+  }
+  runs.erase(runs.begin(), runs.begin() + merged);
+  merged = 0;
+  last = -1;
+}
+
+//
+// GroupBy
+//
+
+// # bits of the hash that select the spill file of a tuple, and # times
+// the tuples of a group can be spilled before the bits of the hash run out
+static const int SPILL_BITS = 4;
+static const int MAX_SPILL_LEVEL = 32 / SPILL_BITS;
+
+GroupBy::GroupBy(Operator* input, int group, int bucket, int function, double estimate,
+                 const string& spillName)
+  : input(input), group(group), bucket(bucket), function(function), estimate(estimate),
+    spillName(spillName)
+{
+  ordered = false;
+  groups = 0;
+  pos = 0;
+  fileCount = 0;
+  batch = NULL;
+  bpos = 0;
+  current.count = 0;
+}
+
+GroupBy::~GroupBy()
+{
+  delete input;
+}
+
+RC GroupBy::open()
+{
+  RC rc;
+
+  if ((rc = input->open()) < 0) return rc;
+  ordered = group == 1 && input->isOrdered();
+  batch = NULL;
+  bpos = 0;
+  current.count = 0;
+  fileCount = 0;
+  if (ordered) return 0;
+
+  // the input is used up here, and next() returns the groups in the table
+  return consume(*input, 0, estimate);
+}
+
+RC GroupBy::next(Tuple& tuple)
+{
+  RC rc;
+
+  // the group of an ordered input ends at the first key past it
+  while (ordered) {
+    if (batch != NULL && bpos < batch->selCount) {
+      int key = batch->keys[batch->sel[bpos]];
+      int g = groupKey(key);
+      if (current.count > 0 && g != current.key) {
+        format(current, tuple);
+        current.count = 0;
+        return 0;
+      }
+      current.key = g;
+      add(current, key);
+      bpos++;
+      continue;
+    }
+
+    bpos = 0;
+    if ((rc = input->nextBatch(batch)) == RC_END_OF_TREE) {
+      batch = NULL;
+      if (current.count == 0) return rc;
+      format(current, tuple);
+      current.count = 0;
+      return 0;
+    }
+    if (rc < 0) return rc;
+  }
+
+  while (true) {
+    for (; pos < slots.size(); pos++) {
+      if (slots[pos].count > 0) {
+        format(slots[pos++], tuple);
+        return 0;
+      }
+    }
+    if (pending.empty()) return RC_END_OF_TREE;
+
+    // the groups in the table are used up, so group the next spill file
+    Spill spill = pending.back();
+    pending.pop_back();
+    if ((rc = regroup(spill)) < 0) return rc;
+  }
+}
+
+RC GroupBy::close()
+{
+  // the spill files that were not grouped are removed
+  for (unsigned i = 0; i < pending.size(); i++) removeRecordFile(pending[i].name);
+  pending.clear();
+  slots.clear();
+  arena.clear();
+  groups = 0;
+  pos = 0;
+  batch = NULL;
+  return input->close();
+}
+
+// group the tuples of in into the table. the tuples of the groups that
+// do not fit in it are spilled to the file that the bits of their hash
+// for the level select, and the spill files are added to pending
+RC GroupBy::consume(Operator& in, int level, double estimate)
+{
+  RC rc;
+  const TupleBatch* b;
+
+  clearTable(estimate);
+  spills.clear();
+  spills.resize(SPILL_PARTITIONS);
+  for (unsigned p = 0; p < spills.size(); p++) spills[p].rf = NULL;
+
+  while ((rc = in.nextBatch(b)) == 0) {
+    for (int j = 0; j < b->selCount; j++) {
+      int i = b->sel[j];
+      int key = b->keys[i];
+      int gkey = group == 1 ? groupKey(key) : 0;
+      const char* value = group == 2 ? b->values[i] : NULL;
+      int length = group == 2 ? b->lengths[i] : 0;
+      unsigned hash = group == 1 ? mixBits(gkey) : hashValue(value, length);
+
+      unsigned s = probe(hash, gkey, value, length);
+      if (slots[s].count == 0) {
+        // a new group goes to the table if it fits in memory
+        if (!grow(length, level)) {
+          if ((rc = spill(hash, key, value, length, level)) < 0) goto consume_done;
+          continue;
+        }
+        s = probe(hash, gkey, value, length);
+        slots[s].hash = hash;
+        slots[s].key = gkey;
+        slots[s].offset = arena.size();
+        slots[s].length = length;
+        arena.append(value != NULL ? value : "", length);
+        groups++;
+      }
+      add(slots[s], key);
+    }
+  }
+
+  consume_done:
+  for (unsigned p = 0; p < spills.size(); p++) {
+    if (spills[p].rf == NULL) continue;
+    RC frc = flush(spills[p]);
+    if (frc < 0 && (rc == 0 || rc == RC_END_OF_TREE)) rc = frc;
+    if (spills[p].rf->close() < 0 && (rc == 0 || rc == RC_END_OF_TREE)) rc = RC_FILE_CLOSE_FAILED;
+    delete spills[p].rf;
+    spills[p].rf = NULL;
+    pending.push_back(spills[p]);
+  }
+  spills.clear();
+  return rc == RC_END_OF_TREE ? 0 : rc;
+}
+
+// group the tuples of a spill file, and remove the file
+RC GroupBy::regroup(const Spill& spill)
+{
+  RC rc;
+  RecordFile rf;
+
+  if ((rc = rf.open(spill.name, 'r')) == 0) {
+    TableScan scan(rf, allTuples, group == 2);
+    if ((rc = scan.open()) == 0) rc = consume(scan, spill.level, spill.count);
+    scan.close();
+    rf.close();
+  }
+  removeRecordFile(spill.name);
+  return rc;
+}
+
+// write a tuple to the spill file of its hash. the file is created
+// when its first tuple is spilled
+RC GroupBy::spill(unsigned hash, int key, const char* value, int length, int level)
+{
+  RC       rc;
+  Spill&   s = spills[(hash >> (32 - SPILL_BITS * (level + 1))) & (SPILL_PARTITIONS - 1)];
+
+  if (s.rf == NULL) {
+    s.level = level + 1;
+    s.count = 0;
+    if ((rc = createTempFile(spillName, fileCount, s.name, s.rf)) < 0) return rc;
+  }
+  s.count++;
+  s.keys.push_back(key);
+  s.values.push_back(value != NULL ? string(value, length) : string());
+  return (int)s.keys.size() < RecordFile::RECORDS_PER_PAGE ? 0 : flush(s);
+}
+
+// append the buffered tuples of a spill file to the file
+RC GroupBy::flush(Spill& s)
+{
+  RC rc;
+  vector<RecordId> rids;
+
+  if (s.keys.empty()) return 0;
+  rc = s.rf->appendBatch(s.keys, s.values, rids);
+  s.keys.clear();
+  s.values.clear();
+  return rc;
+}
+
+// find the slot of a group in the table, or the empty slot for it
+unsigned GroupBy::probe(unsigned hash, int key, const char* value, int length) const
+{
+  unsigned mask = slots.size() - 1;
+  unsigned s = hash & mask;
+
+  for (; slots[s].count > 0; s = (s + 1) & mask) {
+    const Group& g = slots[s];
+    if (g.hash != hash || g.key != key || g.length != length) continue;
+    if (length == 0 || memcmp(arena.data() + g.offset, value, length) == 0) break;
+  }
+  return s;
+}
+
+// make room in the table for a new group with a value of the given
+// length. the table doubles when it is 3/4 full. return false if the
+// groups would take more than MEMORY_BUDGET bytes, unless the tuples
+// were spilled so many times that they cannot be spilled any more
+bool GroupBy::grow(int length, int level)
+{
+  bool   full = (groups + 1) * 4 > (int)slots.size() * 3;
+  double bytes = (full ? 2.0 : 1.0) * slots.size() * sizeof(Group) + arena.size() + length;
+
+  if (bytes > MEMORY_BUDGET && level < MAX_SPILL_LEVEL) return false;
+  if (!full) return true;
+
+  vector<Group> old(slots.size() * 2, Group());
+  old.swap(slots);
+  unsigned mask = slots.size() - 1;
+  for (unsigned i = 0; i < old.size(); i++) {
+    if (old[i].count == 0) continue;
+    unsigned s = old[i].hash & mask;
+    while (slots[s].count > 0) s = (s + 1) & mask;
+    slots[s] = old[i];
+  }
+  return true;
+}
+
+// empty the table, sized for the estimated # groups within MEMORY_BUDGET
+void GroupBy::clearTable(double estimate)
+{
+  unsigned size = 16;
+
+  while (size * 3.0 < estimate * 4 && 2.0 * size * sizeof(Group) <= MEMORY_BUDGET) size *= 2;
+  slots.assign(size, Group());
+  groups = 0;
+  arena.clear();
+  pos = 0;
+}
+
+// add a tuple with the given key to a group
+void GroupBy::add(Group& g, int key)
+{
+  g.minKey = (g.count == 0 || key < g.minKey) ? key : g.minKey;
+  g.maxKey = (g.count == 0 || key > g.maxKey) ? key : g.maxKey;
+  g.sum = (g.count == 0 ? 0 : g.sum) + key;
+  g.count++;
+}
+
+// return a group as a tuple whose value is the group and its aggregate
+void GroupBy::format(const Group& g, Tuple& tuple)
+{
+  char buf[64];
+
+  if (group == 1) {
+    sprintf(buf, "%d ", g.key);
+    row = buf;
+  } else {
+    row = "'";
+    row.append(arena, g.offset, g.length);
+    row += "' ";
+  }
+  formatKeys(function, g.count, g.sum, g.minKey, g.maxKey, buf);
+  row += buf;
+
+  tuple.key = g.key;
+  tuple.value = row.data();
+  tuple.length = row.size();
+  tuple.rid.pid = tuple.rid.sid = -1;
+}
+
+// the group of a key: the first key of its bucket
+int GroupBy::groupKey(int key) const
+{
+  if (bucket == 1) return key;
+
+  long long first = (long long)(key / bucket) * bucket;
+  if (first > key) first -= bucket;  // rounded toward zero
+  return first < INT_MIN ? INT_MIN : (int)first;
+}
+
+//
+// Append
+//
+
+Append::Append(const vector<Operator*>& inputs)
+  : inputs(inputs)
+{
+  current = 0;
+  opened = false;
+}
+
+Append::~Append()
+{
+  for (unsigned i = 0; i < inputs.size(); i++) delete inputs[i];
+}
+
+RC Append::open()
+{
+  RC rc;
+
+  close();
+  current = 0;
+  for (unsigned i = 0; i < inputs.size(); i++) {
+    if ((rc = inputs[i]->open()) < 0) {
+      while (i-- > 0) inputs[i]->close();
+      return rc;
+    }
+  }
+  opened = true;
+  return 0;
+}
+
+RC Append::next(Tuple& tuple)
+{
+  RC rc;
+
+  for (; opened && current < inputs.size(); current++) {
+    if ((rc = inputs[current]->next(tuple)) != RC_END_OF_TREE) return rc;
+
+    // move on to the next input
+    inputs[current]->close();
+  }
+  return RC_END_OF_TREE;
+}
+
+RC Append::nextBatch(const TupleBatch*& batch)
+{
+  RC rc;
+
+  for (; opened && current < inputs.size(); current++) {
+    if ((rc = inputs[current]->nextBatch(batch)) != RC_END_OF_TREE) return rc;
+
+    // move on to the next input
+    inputs[current]->close();
+  }
+  return RC_END_OF_TREE;
+}
+
+RC Append::close()
+{
+  for (unsigned i = current; opened && i < inputs.size(); i++) inputs[i]->close();
+  opened = false;
+  return 0;
+}
+
+bool Append::isOrdered() const
+{
+  for (unsigned i = 0; i < inputs.size(); i++) {
+    if (!inputs[i]->isOrdered()) return false;
+  }
+  return true;
+}
@@ -0,0 +1,561 @@
+/*
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef OPERATOR_H
+#define OPERATOR_H
+
+#include <set>
+#include <string>
+#include <vector>
+#include "Bruinbase.h"
+#include "RecordFile.h"
+#include "BTreeIndex.h"
+#include "ColumnFile.h"
+#include "SSTable.h"
+#include "Predicate.h"
+#include "TupleBatch.h"
+
+/**
+ * a tuple passed between operators.
+ * the value is not terminated by zero and stays valid until the next
+ * call to next() on the operator that returned the tuple.
+ */
+typedef struct {
+  int         key;     // the key
+  const char* value;   // the value. NULL if it was not read
+  int         length;  // the length of the value
+  RecordId    rid;     // the record of the tuple in a row table
+} Tuple;
+
+/**
+ * a physical operator of a query plan. the operators form a tree and
+ * pass tuples up one at a time:
+ *
+ *   if ((rc = op->open()) < 0) ...
+ *   while ((rc = op->next(tuple)) == 0) { ... }
+ *   if (rc != RC_END_OF_TREE) ...
+ *   op->close();
+ *
+ * an operator takes over the operators given to its constructor
+ * and deletes them when it is deleted.
+ *
+ * the tuples can also be taken in batches by nextBatch(). the operators
+ * that read tuples in batches return their batches as they are.
+ */
+class Operator {
+ public:
+  Operator() : out(NULL) {}
+  virtual ~Operator() { delete out; }
+
+  /**
+   * prepare the operator and its inputs to return tuples.
+   * @return error code. 0 if no error
+   */
+  virtual RC open() = 0;
+
+  /**
+   * return the next tuple.
+   * @param tuple[OUT] the tuple
+   * @return RC_END_OF_TREE after the last tuple. 0 if no error
+   */
+  virtual RC next(Tuple& tuple) = 0;
+
+  /**
+   * return the next tuples as the selected tuples of a batch. the values
+   * are valid only if the operator returns values, and the batch stays
+   * valid until the next call to next() or nextBatch(). by default the
+   * batch is filled by next() and the values are copied into it.
+   * @param batch[OUT] the batch. it may select no tuple before the end
+   * @return RC_END_OF_TREE after the last tuple. 0 if no error
+   */
+  virtual RC nextBatch(const TupleBatch*& batch);
+
+  /**
+   * @return true if the tuples are returned in key order. this is
+   * known after open()
+   */
+  virtual bool isOrdered() const { return false; }
+
+  /**
+   * release the resources taken by open().
+   * @return error code. 0 if no error
+   */
+  virtual RC close() = 0;
+
+ protected:
+  TupleBatch* out;  // the batch filled by the default nextBatch()
+};
+
+/**
+ * full scan of a row table in batches of pages (see TupleBatch).
+ * the pages that the zone map rules out are skipped, and the conditions
+ * are checked on every batch, the key first. a value is read only for
+ * the tuples whose key meets them, and only if it is needed.
+ */
+class TableScan : public Operator {
+ public:
+  /**
+   * @param rf[IN] the table. it must stay open during the scan
+   * @param pred[IN] the conditions that the tuples must meet
+   * @param needValues[IN] whether the values are returned
+   */
+  TableScan(RecordFile& rf, const Predicate& pred, bool needValues);
+  ~TableScan();
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC nextBatch(const TupleBatch*& batch);
+  RC close();
+
+ private:
+  RC nextBatch();
+
+  RecordFile&         rf;
+  const Predicate&    pred;
+  bool                needValues;
+  RecordFile::Scanner sc;
+  TupleBatch*         batch;   // the batch in memory
+  int                 pos;     // the position in its selection vector
+};
+
+/**
+ * range scan of a B+tree index over the key range of the conditions.
+ * only the keys are checked. the entries are read as the tuples are
+ * returned, and the values are fetched in key order, unless fetching
+ * the first LOOKAHEAD tuples in key order reads pages again. then all
+ * the entries are read first and the values fetched in rid order. the
+ * tuples are returned in key order either way.
+ */
+class IndexScan : public Operator {
+ public:
+  static const unsigned LOOKAHEAD = 1024;  // # entries that decide the fetch order
+
+  /**
+   * @param tree[IN] the index. it must stay open during the scan
+   * @param rf[IN] the table to fetch the values from. NULL not to read them
+   * @param pred[IN] the conditions on the key
+   */
+  IndexScan(BTreeIndex& tree, const RecordFile* rf, const Predicate& pred);
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+
+  /**
+   * @return true if the values were fetched in rid order
+   */
+  bool isSorted() const { return sorted; }
+
+ private:
+  void readEntries(unsigned count);
+
+  BTreeIndex&              tree;
+  const RecordFile*        rf;
+  const Predicate&         pred;
+  IndexCursor              cursor;   // the next entry in the index
+  std::vector<IndexEntry>  entries;  // the entries read ahead
+  std::vector<std::string> values;   // values[i] is the value of entries[i], if sorted
+  std::string              value;    // the value of the tuple returned last otherwise
+  bool                     sorted;
+  bool                     done;     // no entry left in the key range
+  unsigned                 pos;      // # entries read ahead that were returned
+};
+
+/**
+ * the smallest or the largest key of a B+tree index that meets the
+ * conditions on the key, as a single tuple without value. the smallest
+ * one is the first key of the range scan. the largest one is read from
+ * the rightmost leaf node, and the range is scanned only if that key
+ * does not meet the conditions.
+ */
+class KeyProbe : public Operator {
+ public:
+  /**
+   * @param tree[IN] the index. it must stay open during the scan
+   * @param pred[IN] the conditions on the key
+   * @param last[IN] false for the smallest key, true for the largest one
+   */
+  KeyProbe(BTreeIndex& tree, const Predicate& pred, bool last);
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+
+ private:
+  BTreeIndex&      tree;
+  const Predicate& pred;
+  bool             last;
+  bool             found;  // whether a key meets the conditions
+  int              key;    // the key found
+  bool             done;
+};
+
+/**
+ * range scan of an SSTable over the key range of the conditions.
+ * only the keys are checked.
+ */
+class SSTableScan : public Operator {
+ public:
+  /**
+   * @param sst[IN] the table. it must stay open during the scan
+   * @param pred[IN] the conditions on the key
+   */
+  SSTableScan(SSTable& sst, const Predicate& pred);
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+
+ private:
+  SSTable&         sst;
+  const Predicate& pred;
+  SSTableCursor    cursor;
+  bool             done;
+};
+
+/**
+ * scan of a column table, through its index if tree is not NULL.
+ * the conditions on the key are checked first and the value column is
+ * read only for the rows that pass them, and only if needed. with a
+ * dictionary, equality conditions on the value are checked on codes.
+ */
+class ColumnScan : public Operator {
+ public:
+  /**
+   * @param cf[IN] the table. it must stay open during the scan
+   * @param tree[IN] the index of the table, or NULL
+   * @param cond[IN] the conditions the predicate was compiled from
+   * @param pred[IN] the conditions that the rows must meet
+   * @param needValues[IN] whether the values are returned
+   */
+  ColumnScan(ColumnFile& cf, BTreeIndex* tree, const std::vector<SelCond>& cond,
+             const Predicate& pred, bool needValues);
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+
+ private:
+  RC matchRow(int row, bool& match);
+
+  ColumnFile&                 cf;
+  BTreeIndex*                 tree;
+  const std::vector<SelCond>& cond;
+  const Predicate&            pred;
+  bool                        needValues;
+  std::vector<int>            codes;   // the dictionary codes of the conditions
+  IndexCursor                 cursor;
+  int                         row;     // the next row to scan without index
+  bool                        done;
+  std::string                 value;
+};
+
+/**
+ * return the tuples of the input that meet the conditions.
+ * the conditions on the value need the input to return values.
+ */
+class Filter : public Operator {
+ public:
+  Filter(Operator* input, const Predicate& pred);
+  ~Filter();
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+
+ private:
+  Operator*        input;
+  const Predicate& pred;
+};
+
+/**
+ * return the attributes of the input tuples in the SELECT clause
+ * (1: key, 2: value, 3: *). the value is dropped for attr 1.
+ */
+class Project : public Operator {
+ public:
+  Project(Operator* input, int attr);
+  ~Project();
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+
+ private:
+  Operator* input;
+  int       attr;
+};
+
+/**
+ * compute an aggregate function over the input tuples and return its
+ * result as the value of a single tuple. the input is read in batches,
+ * and SUM, AVG, MIN and MAX on the key run over the key array of every
+ * batch. SUM, AVG, MIN and MAX of no tuples are NULL.
+ */
+class Aggregate : public Operator {
+ public:
+  /**
+   * @param input[IN] the input
+   * @param function[IN] the attribute in the SELECT clause: 4 for
+   * count(*), or an aggregate function of SqlEngine such as SUM_KEY
+   */
+  Aggregate(Operator* input, int function);
+  ~Aggregate();
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+
+ private:
+  void add(const TupleBatch& batch);
+
+  Operator*   input;
+  int         function;
+  long long   count;      // # input tuples
+  long long   sum;        // the sum of the keys
+  int         minKey, maxKey;
+  std::string minValue, maxValue;
+  std::set<int>         keys;     // the distinct keys
+  std::set<std::string> values;   // the distinct values
+  std::string result;
+  bool        done;
+};
+
+/**
+ * return the first n tuples of the input.
+ */
+class Limit : public Operator {
+ public:
+  Limit(Operator* input, int n);
+  ~Limit();
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+
+ private:
+  Operator* input;
+  int       n;
+  int       returned;
+};
+
+/**
+ * return the input tuples ordered by key or by value, ascending or
+ * descending, up to a limit. tuples that compare equal keep their
+ * input order. the input is read by open().
+ *
+ * the tuples are sorted in memory up to MEMORY_BUDGET bytes. past that,
+ * every MEMORY_BUDGET bytes are sorted into a run written to a temporary
+ * record file, and the runs are merged, MERGE_FAN_IN runs at a time. the
+ * last merge returns its tuples as they are merged. with a small limit,
+ * only the first tuples are kept, in a heap of limit tuples. an input
+ * that returns its tuples in key order is not sorted again by key.
+ */
+class Sort : public Operator {
+ public:
+  static const int MEMORY_BUDGET = 1 << 20;  // # bytes of tuples sorted in memory
+  static const int MERGE_FAN_IN = 16;        // # runs merged at a time
+
+  /**
+   * @param input[IN] the input
+   * @param order[IN] the attribute to order by (1: key, 2: value),
+   * negated for descending order
+   * @param limit[IN] # tuples to return at most. -1 for all of them
+   * @param needValues[IN] whether the values are returned
+   * @param spillName[IN] the prefix of the names of the run files
+   */
+  Sort(Operator* input, int order, int limit, bool needValues, const std::string& spillName);
+  ~Sort();
+
+  /**
+   * @param limit[IN] # tuples to return at most. -1 for all of them
+   * @return true if the first limit tuples are kept in a heap, so that
+   * no run is ever written
+   */
+  static bool fitsHeap(int limit);
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+  bool isOrdered() const { return order == 1; }
+
+ private:
+  // a tuple in memory. seq is its position in the input
+  struct Entry {
+    int         key;
+    int         seq;
+    std::string value;
+  };
+
+  // the order of the entries, with the position in the input
+  // breaking the ties if bySeq is set
+  struct EntryLess {
+    int  order;
+    bool bySeq;
+    EntryLess(int order, bool bySeq) : order(order), bySeq(bySeq) {}
+    bool operator()(const Entry& e1, const Entry& e2) const;
+  };
+
+  // a sorted run on disk, and its next tuple while it is merged
+  struct Run {
+    std::string name;
+    RecordFile* rf;
+    TableScan*  scan;
+    Tuple       tuple;
+    bool        done;   // no tuple left
+  };
+
+  RC   add(int key, const char* value, int length);
+  RC   createRun(Run& run);
+  RC   writeRun();
+  RC   mergeRuns(unsigned count);
+  RC   openRuns(unsigned count);
+  RC   nextMerged(Tuple& tuple);
+  RC   advance(Run& run);
+  void closeRuns();
+
+  Operator*          input;
+  int                order;
+  int                limit;
+  bool               needValues;
+  std::string        spillName;
+  bool               useHeap;      // only the first limit tuples are kept
+  bool               passThrough;  // the input is in order already
+
+  std::vector<Entry> entries;      // the tuples in memory
+  double             bytes;        // # bytes they take
+  int                seq;          // # input tuples read
+  std::vector<Run>   runs;         // the runs on disk, in input order
+  unsigned           merged;       // # runs being merged, the first ones
+  int                last;         // the run of the tuple returned last. -1 if none
+  int                fileCount;    // # run files created
+  unsigned           pos;          // # tuples returned
+};
+
+/**
+ * group the input tuples by key, by key bucket or by value, and compute
+ * count(*), or the sum, the average, the smallest or the largest key of
+ * every group. every group is returned as a tuple whose key is the group
+ * key, and whose value is the group and its aggregate as printed.
+ *
+ * when the groups are keys and the input comes in key order, a group is
+ * complete as soon as a key past it is read, so the groups are returned
+ * as they are read and nothing is kept in memory. otherwise the groups
+ * are collected in an open-addressing hash table, sized from the
+ * estimated # groups. when the table would take more than MEMORY_BUDGET
+ * bytes, the tuples of the groups not in it are spilled to one of
+ * SPILL_PARTITIONS temporary record files by their hash, and every file
+ * is grouped in turn after the groups in memory are returned.
+ */
+class GroupBy : public Operator {
+ public:
+  static const int MEMORY_BUDGET = 1 << 20;  // # bytes of groups in memory
+  static const int SPILL_PARTITIONS = 16;    // # spill files per table
+
+  /**
+   * @param input[IN] the input
+   * @param group[IN] the attribute in the GROUP BY clause (1: key, 2: value)
+   * @param bucket[IN] the width of the key buckets. 1 to group by key
+   * @param function[IN] the aggregate in the SELECT clause: 4 for
+   * count(*), or SUM_KEY, AVG_KEY, MIN_KEY or MAX_KEY of SqlEngine
+   * @param estimate[IN] the estimated # groups. -1 if unknown
+   * @param spillName[IN] the prefix of the names of the spill files
+   */
+  GroupBy(Operator* input, int group, int bucket, int function, double estimate,
+          const std::string& spillName);
+  ~GroupBy();
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC close();
+
+ private:
+  // the aggregate of a group. count is 0 for an empty slot
+  struct Group {
+    unsigned  hash;    // the hash of the group
+    int       key;     // the group key: the key, or the first key of the bucket
+    int       offset;  // the value of the group in the arena
+    int       length;  // the length of the value
+    long long count;   // # tuples in the group
+    long long sum;     // the sum of their keys
+    int       minKey, maxKey;
+  };
+
+  // a spill file. its tuples are buffered and appended a page at a time
+  struct Spill {
+    std::string name;
+    RecordFile* rf;    // the file while it is written
+    int         level; // # times its tuples were spilled
+    int         count; // # tuples in the file
+    std::vector<int>         keys;    // the tuples not written yet
+    std::vector<std::string> values;
+  };
+
+  RC       consume(Operator& in, int level, double estimate);
+  RC       regroup(const Spill& spill);
+  RC       spill(unsigned hash, int key, const char* value, int length, int level);
+  RC       flush(Spill& s);
+  unsigned probe(unsigned hash, int key, const char* value, int length) const;
+  bool     grow(int length, int level);
+  void     clearTable(double estimate);
+  void     add(Group& g, int key);
+  void     format(const Group& g, Tuple& tuple);
+  int      groupKey(int key) const;
+
+  Operator*          input;
+  int                group;
+  int                bucket;
+  int                function;
+  double             estimate;
+  std::string        spillName;
+  bool               ordered;  // the groups are read in key order
+
+  std::vector<Group> slots;    // the hash table
+  int                groups;   // # groups in the table
+  std::string        arena;    // the values of the groups in the table
+  unsigned           pos;      // the next slot to return
+  std::vector<Spill> spills;   // the spill files being written, by partition
+  std::vector<Spill> pending;  // the spill files still to group
+  int                fileCount; // # spill files created
+
+  const TupleBatch*  batch;    // the input batch of an ordered input
+  int                bpos;     // the position in its selection vector
+  Group              current;  // the group being read from an ordered input
+
+  std::string        row;      // the value of the tuple returned
+};
+
+/**
+ * return the tuples of the inputs one input after another. the inputs
+ * are all opened by open(), so that an error shows up before any output
+ * and it is known whether they return their tuples in key order, and
+ * every one is closed when it is used up.
+ */
+class Append : public Operator {
+ public:
+  Append(const std::vector<Operator*>& inputs);
+  ~Append();
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC nextBatch(const TupleBatch*& batch);
+  RC close();
+
+  /**
+   * @return true if every input returns its tuples in key order. the
+   * inputs must come in key order too, like the partitions of a table
+   */
+  bool isOrdered() const;
+
+ private:
+  std::vector<Operator*> inputs;
+  unsigned               current;  // the input in use
+  bool                   opened;   // whether the inputs from current on are open
+};
+
+#endif // OPERATOR_H
@@ -10,29 +10,72 @@
 #include "Bruinbase.h"
 #include "PageFile.h"
 #include <fcntl.h>
+#include <unistd.h>
 #include <sys/stat.h>
 
 using std::string;
 
 int PageFile::readCount = 0;
 int PageFile::writeCount = 0;
+int PageFile::byteReadCount = 0;
 int PageFile::cacheClock = 1;
 struct PageFile::cacheStruct PageFile::readCache[PageFile::CACHE_COUNT];
 
+//
+// A compressed file stores every page with an LZ77 codec in the style of
+// LZ4. A compressed page is a sequence of
+//
+// |token|literal length...|literals|offset (2 bytes)|match length...|
+//
+// The upper four bits of the token are # literals and the lower four bits
+// are the match length - MIN_MATCH. The value 15 means that more bytes
+// follow, each adding up to 255. The last sequence has literals only.
+// A page that does not compress is stored as it is with length PAGE_SIZE.
+//
+// The page map (filename.pmap) stores the extent (offset, capacity, length)
+// of every page. A page is rewritten in place if it fits in its extent,
+// otherwise it moves to the end of the file.
+//
+// The free list (filename.free) stores the ids of the free pages of a file
+// as ints in ascending order. The file exists only while the list is not
+// empty.
+//
+
+// the shortest match encoded as a match
+static const int MIN_MATCH = 4;
+
+// the size of an extent in the page map
+static const int EXTENT_SIZE = sizeof(int) + 2*sizeof(short);
+
+// compress a page. returns the compressed length, or PAGE_SIZE if
+// the page does not compress
+static int compressPage(const char* page, char* out);
+
+// decompress a page. returns false if the compressed page is broken
+static bool decompressPage(const char* in, int length, char* page);
+
 PageFile::PageFile() 
 { 
   fd = -1; 
   epid = 0; 
+  mfd = -1;
+  dataEnd = 0;
+  mapDirty = -1;
+  freeDirty = false;
 }
 
 PageFile::PageFile(const string& filename, char mode)
 {
   fd = -1;
   epid = 0;
+  mfd = -1;
+  dataEnd = 0;
+  mapDirty = -1;
+  freeDirty = false;
   open(filename.c_str(), mode);
 }
 
-RC PageFile::open(const string& filename, char mode)
+RC PageFile::open(const string& filename, char mode, bool compress)
 {
   RC   rc;
   int  oflag;
@@ -63,6 +106,46 @@ RC PageFile::open(const string& filename, char mode)
   if (rc < 0) { ::close(fd); fd = -1; return RC_FILE_OPEN_FAILED; }
   epid = statbuf.st_size / PAGE_SIZE;
 
+  // a file with a page map is compressed. the page map of an empty
+  // file is left over from an earlier file and is used only if
+  // compression is asked for
+  string mapname = filename + ".pmap";
+  bool empty = (statbuf.st_size == 0);
+  mfd = ::open(mapname.c_str(), (oflag == O_RDONLY) ? O_RDONLY : O_RDWR);
+  if (mfd < 0 && empty && compress && oflag != O_RDONLY) {
+    mfd = ::open(mapname.c_str(), O_RDWR|O_CREAT, 0644);
+  }
+  if (mfd >= 0 && empty && !(compress && oflag != O_RDONLY)) {
+    ::close(mfd);
+    mfd = -1;
+  }
+  if (mfd >= 0) {
+    dataEnd = statbuf.st_size;
+    mapDirty = -1;
+    if ((rc = readMap(empty)) < 0) {
+      ::close(mfd);
+      ::close(fd);
+      mfd = fd = -1;
+      return rc;
+    }
+    epid = extents.size();
+  }
+
+  // read the free list. the free list of an empty file is left over
+  // from an earlier file and is dropped
+  freeName = filename + ".free";
+  freePages.clear();
+  freeDirty = false;
+  if (epid == 0) {
+    if (oflag != O_RDONLY) ::unlink(freeName.c_str());
+  } else if ((rc = readFreeList()) < 0) {
+    if (mfd >= 0) ::close(mfd);
+    ::close(fd);
+    mfd = fd = -1;
+    extents.clear();
+    return rc;
+  }
+
   return 0;
 }
 
@@ -70,6 +153,24 @@ RC PageFile::close()
 {
   if (fd <= 0) return RC_FILE_CLOSE_FAILED;
 
+  // write the free list, which may also shorten the file
+  RC frc = freeDirty ? writeFreeList() : 0;
+  freePages.clear();
+  if (frc < 0) {
+    if (mfd >= 0) { ::close(mfd); mfd = -1; extents.clear(); }
+    ::close(fd); fd = -1; epid = 0;
+    return frc;
+  }
+
+  // write the page map of a compressed file
+  if (mfd >= 0) {
+    RC rc = writeMap();
+    ::close(mfd);
+    mfd = -1;
+    extents.clear();
+    if (rc < 0) { ::close(fd); fd = -1; epid = 0; return rc; }
+  }
+
   // close the file
   if (::close(fd) < 0) return RC_FILE_CLOSE_FAILED;
 
@@ -93,6 +194,30 @@ PageId PageFile::endPid() const
   return epid;
 }
 
+RC PageFile::allocPage(PageId& pid)
+{
+  if (freePages.empty()) {
+    pid = epid;
+    return 0;
+  }
+
+  // fill the holes near the beginning of the file first,
+  // so that free pages gather at the end where they are cut off
+  pid = *freePages.begin();
+  freePages.erase(freePages.begin());
+  freeDirty = true;
+  return 0;
+}
+
+RC PageFile::freePage(PageId pid)
+{
+  if (pid < 0 || pid >= epid) return RC_INVALID_PID;
+
+  freePages.insert(pid);
+  freeDirty = true;
+  return 0;
+}
+
 RC PageFile::seek(PageId pid) const
 {
   return (::lseek(fd, pid * PAGE_SIZE, SEEK_SET) < 0) ? RC_FILE_SEEK_FAILED : 0;
@@ -103,11 +228,33 @@ RC PageFile::write(PageId pid, const void* buffer)
   RC rc;
   if (pid < 0) return RC_INVALID_PID; 
 
-  // seek to the location of the page
-  if ((rc = seek(pid) < 0)) return rc;
+  if (mfd >= 0) {
+    // compress the page. pages skipped over are left empty
+    char data[PAGE_SIZE];
+    int  length = compressPage((const char*)buffer, data);
+    const void* src = (length == PAGE_SIZE) ? buffer : data;
+    if (pid >= (PageId)extents.size()) {
+      Extent e = { 0, 0, 0 };
+      extents.resize(pid + 1, e);
+    }
 
-  // write the buffer to the disk page
-  if (::write(fd, buffer, PAGE_SIZE) < 0) return RC_FILE_WRITE_FAILED;
+    // rewrite the page in place if it fits, or move it to the end
+    Extent& e = extents[pid];
+    if (length > e.capacity) {
+      e.offset = dataEnd;
+      e.capacity = length;
+      dataEnd += length;
+    }
+    e.length = length;
+    if (::pwrite(fd, src, length, e.offset) < 0) return RC_FILE_WRITE_FAILED;
+    if (mapDirty < 0 || pid < mapDirty) mapDirty = pid;
+  } else {
+    // seek to the location of the page
+    if ((rc = seek(pid) < 0)) return rc;
+
+    // write the buffer to the disk page
+    if (::write(fd, buffer, PAGE_SIZE) < 0) return RC_FILE_WRITE_FAILED;
+  }
 
   // if the page is in read cache, invalidate it
   for (int i = 0; i < CACHE_COUNT; i++) {
@@ -147,9 +294,6 @@ RC PageFile::read(PageId pid, void* buffer) const
     }
   }
 
-  // seek to the page
-  if ((rc = seek(pid) < 0)) return rc;
-  
   // find the cache slot to evict
   int toEvict = 0; 
   for (int i = 0; i < CACHE_COUNT; i++) {
@@ -165,14 +309,256 @@ RC PageFile::read(PageId pid, void* buffer) const
   readCache[toEvict].pid = pid;
   readCache[toEvict].lastAccessed = ++cacheClock;
  
-  // read the page to cache first and copy it to the buffer
-  if (::read(fd, readCache[toEvict].buffer, PAGE_SIZE) < 0) {
-    return RC_FILE_READ_FAILED;
+  // read the page to cache first and copy it to the buffer.
+  // the cache keeps compressed pages decompressed
+  char* frame = readCache[toEvict].buffer;
+  if (mfd >= 0) {
+    const Extent& e = extents[pid];
+    char data[PAGE_SIZE];
+    if (e.length == 0) {
+      memset(frame, 0, PAGE_SIZE);
+    } else if (::pread(fd, e.length == PAGE_SIZE ? frame : data, e.length, e.offset) != e.length ||
+               (e.length < PAGE_SIZE && !decompressPage(data, e.length, frame))) {
+      readCache[toEvict].lastAccessed = 0;
+      return RC_FILE_READ_FAILED;
+    }
+    byteReadCount += e.length;
+  } else {
+    // seek to the page
+    if ((rc = seek(pid) < 0)) return rc;
+    if (::read(fd, frame, PAGE_SIZE) < 0) {
+      return RC_FILE_READ_FAILED;
+    }
+    byteReadCount += PAGE_SIZE;
   }
-  memcpy(buffer, readCache[toEvict].buffer, PAGE_SIZE);
+  memcpy(buffer, frame, PAGE_SIZE);
 
   // increase the page read count
   readCount++;
 
   return 0;
 }
+
+RC PageFile::readMap(bool reset)
+{
+  struct stat statbuf;
+
+  // the page map of a new file starts empty
+  if (reset) {
+    extents.clear();
+    return (::ftruncate(mfd, 0) < 0) ? RC_FILE_WRITE_FAILED : 0;
+  }
+
+  if (::fstat(mfd, &statbuf) < 0) return RC_FILE_READ_FAILED;
+  int n = statbuf.st_size / EXTENT_SIZE;
+  std::vector<char> data(n * EXTENT_SIZE + 1);
+  if (::pread(mfd, &data[0], n * EXTENT_SIZE, 0) != n * EXTENT_SIZE) return RC_FILE_READ_FAILED;
+
+  extents.resize(n);
+  for (int i = 0; i < n; i++) {
+    const char* ptr = &data[i * EXTENT_SIZE];
+    memcpy(&extents[i].offset, ptr, sizeof(int));
+    memcpy(&extents[i].capacity, ptr + sizeof(int), sizeof(short));
+    memcpy(&extents[i].length, ptr + sizeof(int) + sizeof(short), sizeof(short));
+  }
+
+  // reading the page map costs as many pages as it spans
+  readCount += (n * EXTENT_SIZE + PAGE_SIZE - 1) / PAGE_SIZE;
+  byteReadCount += n * EXTENT_SIZE;
+  return 0;
+}
+
+RC PageFile::writeMap()
+{
+  if (mapDirty < 0) return 0;
+
+  // write the extents from the first updated one on
+  int n = extents.size() - mapDirty;
+  std::vector<char> data(n * EXTENT_SIZE + 1);
+  for (int i = 0; i < n; i++) {
+    char* ptr = &data[i * EXTENT_SIZE];
+    const Extent& e = extents[mapDirty + i];
+    memcpy(ptr, &e.offset, sizeof(int));
+    memcpy(ptr + sizeof(int), &e.capacity, sizeof(short));
+    memcpy(ptr + sizeof(int) + sizeof(short), &e.length, sizeof(short));
+  }
+  if (::pwrite(mfd, &data[0], n * EXTENT_SIZE, mapDirty * EXTENT_SIZE) < 0) {
+    return RC_FILE_WRITE_FAILED;
+  }
+
+  mapDirty = -1;
+  return 0;
+}
+
+RC PageFile::readFreeList()
+{
+  struct stat statbuf;
+
+  int ffd = ::open(freeName.c_str(), O_RDONLY);
+  if (ffd < 0) return 0;
+
+  if (::fstat(ffd, &statbuf) < 0) { ::close(ffd); return RC_FILE_READ_FAILED; }
+  int n = statbuf.st_size / sizeof(PageId);
+  std::vector<PageId> pids(n + 1);
+  if (::read(ffd, &pids[0], n * sizeof(PageId)) != (ssize_t)(n * sizeof(PageId))) {
+    ::close(ffd);
+    return RC_FILE_READ_FAILED;
+  }
+  ::close(ffd);
+
+  // ignore the pages past the end of the file
+  for (int i = 0; i < n; i++) {
+    if (pids[i] >= 0 && pids[i] < epid) freePages.insert(pids[i]);
+  }
+
+  // reading the free list costs as many pages as it spans
+  readCount += (n * sizeof(PageId) + PAGE_SIZE - 1) / PAGE_SIZE;
+  byteReadCount += n * sizeof(PageId);
+  return 0;
+}
+
+RC PageFile::writeFreeList()
+{
+  // give the free pages at the end of an uncompressed file back.
+  // pages of a compressed file are located through the page map
+  // and are only reused
+  if (mfd < 0) {
+    PageId end = epid;
+    while (!freePages.empty() && *freePages.rbegin() == end - 1) {
+      freePages.erase(--freePages.end());
+      end--;
+    }
+    if (end < epid) {
+      if (::ftruncate(fd, (off_t)end * PAGE_SIZE) < 0) return RC_FILE_WRITE_FAILED;
+      epid = end;
+    }
+  }
+  freeDirty = false;
+
+  if (freePages.empty()) {
+    ::unlink(freeName.c_str());
+    return 0;
+  }
+
+  std::vector<PageId> pids(freePages.begin(), freePages.end());
+  ssize_t size = pids.size() * sizeof(PageId);
+  int ffd = ::open(freeName.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  if (ffd < 0) return RC_FILE_WRITE_FAILED;
+  bool ok = (::write(ffd, &pids[0], size) == size);
+  ::close(ffd);
+  return ok ? 0 : RC_FILE_WRITE_FAILED;
+}
+
+// append a length that does not fit in the four bits of a token
+static char* putLength(char* op, int length)
+{
+  while (length >= 255) {
+    *op++ = (char)255;
+    length -= 255;
+  }
+  *op++ = length;
+  return op;
+}
+
+static int compressPage(const char* page, char* out)
+{
+  const int HASH_BITS = 8;
+  short table[1 << HASH_BITS];  // the last position of every hashed 4 bytes
+  const char* end = out + PageFile::PAGE_SIZE - 1;
+  char* op = out;
+  int   anchor = 0;  // the first literal not yet written
+  int   ip = 0;
+
+  for (int i = 0; i < (1 << HASH_BITS); i++) table[i] = -1;
+
+  while (ip + MIN_MATCH <= PageFile::PAGE_SIZE) {
+    unsigned seq;
+    memcpy(&seq, page + ip, sizeof(unsigned));
+    unsigned h = (seq * 2654435761u) >> (32 - HASH_BITS);
+    int ref = table[h];
+    table[h] = ip;
+
+    if (ref < 0 || memcmp(page + ref, page + ip, MIN_MATCH) != 0) {
+      ip++;
+      continue;
+    }
+
+    // extend the match as far as it goes
+    int length = MIN_MATCH;
+    while (ip + length < PageFile::PAGE_SIZE && page[ref + length] == page[ip + length]) length++;
+
+    // give up if the sequence may not fit in less than a page
+    int literals = ip - anchor;
+    if (op + 1 + literals/255 + 1 + literals + 2 + length/255 + 1 > end) return PageFile::PAGE_SIZE;
+
+    // write the literals before the match, then the match
+    char* token = op++;
+    *token = ((literals < 15 ? literals : 15) << 4) | (length - MIN_MATCH < 15 ? length - MIN_MATCH : 15);
+    if (literals >= 15) op = putLength(op, literals - 15);
+    memcpy(op, page + anchor, literals);
+    op += literals;
+    unsigned short offset = ip - ref;
+    memcpy(op, &offset, sizeof(short));
+    op += sizeof(short);
+    if (length - MIN_MATCH >= 15) op = putLength(op, length - MIN_MATCH - 15);
+
+    ip += length;
+    anchor = ip;
+  }
+
+  // the last sequence has literals only
+  int literals = PageFile::PAGE_SIZE - anchor;
+  if (op + 1 + literals/255 + 1 + literals > end) return PageFile::PAGE_SIZE;
+  *op++ = (literals < 15 ? literals : 15) << 4;
+  if (literals >= 15) op = putLength(op, literals - 15);
+  memcpy(op, page + anchor, literals);
+  op += literals;
+
+  return op - out;
+}
+
+static bool decompressPage(const char* in, int length, char* page)
+{
+  const unsigned char* ip = (const unsigned char*)in;
+  const unsigned char* iend = ip + length;
+  int op = 0;
+
+  while (ip < iend) {
+    int token = *ip++;
+
+    // copy the literals
+    int literals = token >> 4;
+    if (literals == 15) {
+      int b;
+      do {
+        if (ip >= iend) return false;
+        literals += (b = *ip++);
+      } while (b == 255);
+    }
+    if (ip + literals > iend || op + literals > PageFile::PAGE_SIZE) return false;
+    memcpy(page + op, ip, literals);
+    ip += literals;
+    op += literals;
+
+    // the last sequence has no match
+    if (ip == iend) break;
+
+    // copy the match byte by byte, since it may overlap itself
+    unsigned short offset;
+    if (ip + sizeof(short) > iend) return false;
+    memcpy(&offset, ip, sizeof(short));
+    ip += sizeof(short);
+    int matchLength = (token & 15) + MIN_MATCH;
+    if ((token & 15) == 15) {
+      int b;
+      do {
+        if (ip >= iend) return false;
+        matchLength += (b = *ip++);
+      } while (b == 255);
+    }
+    if (offset == 0 || offset > op || op + matchLength > PageFile::PAGE_SIZE) return false;
+    for (int i = 0; i < matchLength; i++, op++) page[op] = page[op - offset];
+  }
+
+  return op == PageFile::PAGE_SIZE;
+}
@@ -11,6 +11,8 @@
 #define PAGEFILE_H
 
 #include <string>
+#include <vector>
+#include <set>
 #include "Bruinbase.h"
 
 typedef int PageId;
@@ -22,6 +24,7 @@ class PageFile {
  public:
 
   static const int PAGE_SIZE = 1024;    // the size of a page is 1KB
+  static const int CACHE_COUNT = 10;    // # pages in the LRU read cache
 
   PageFile();
   PageFile(const std::string& filename, char mode);
@@ -29,11 +32,15 @@ class PageFile {
   /**
    * open a file in read or write mode.
    * when opened in 'w' mode, if the file does not exist, it is created.
+   * a file created with compress stores every page compressed, and the
+   * location of the pages in the file in filename.pmap. an existing
+   * file is always opened the way it was created.
    * @param filename[IN] the name of the file to open
    * @param mode[IN] 'r' for read, 'w' for write
+   * @param compress[IN] whether to compress the pages of a new file
    * @return error code. 0 if no error
    */
-  RC open(const std::string& filename, char mode);
+  RC open(const std::string& filename, char mode, bool compress = false);
 
   /**
    * close the file.
@@ -66,6 +73,34 @@ class PageFile {
    */
   PageId endPid() const;
 
+  /**
+   * @return true if the pages of the file are stored compressed
+   */
+  bool isCompressed() const { return mfd >= 0; }
+
+  /**
+   * get a page to store new data in: the smallest page on the free list,
+   * or endPid() if the free list is empty. the page is taken off the list.
+   * @param pid[OUT] the page to write the new data to
+   * @return error code. 0 if no error
+   */
+  RC allocPage(PageId& pid);
+
+  /**
+   * put a page that is no longer used on the free list, so that
+   * allocPage() hands it out again. the free list is kept in
+   * filename.free. when the file is closed, the free pages at the
+   * end of an uncompressed file are cut off the file.
+   * @param pid[IN] the page to free
+   * @return error code. 0 if no error
+   */
+  RC freePage(PageId pid);
+
+  /**
+   * @return # pages on the free list
+   */
+  int getFreePageCount() const { return freePages.size(); }
+
   /**
    * @return the total # of disk reads
    */
@@ -76,6 +111,12 @@ class PageFile {
    */
   static int getPageWriteCount() { return writeCount; }
 
+  /**
+   * @return the total # of bytes read from disk.
+   * a compressed page costs only its compressed size
+   */
+  static int getByteReadCount() { return byteReadCount; }
+
  protected:
   /**
    * move the file cursor to the beginning of a page.
@@ -86,14 +127,34 @@ class PageFile {
   RC seek(PageId pid) const;
 
  private:
+  RC readMap(bool reset);
+  RC writeMap();
+  RC readFreeList();
+  RC writeFreeList();
+
   int     fd;     // file descriptor of the associated unix file
   PageId  epid;   // (last page id + 1) of the file
 
   //
-  // the following set of members implement LRU caching 
+  // the following members are used for compressed files only
   //
-  static const int CACHE_COUNT = 10;
+  struct Extent {
+    int   offset;    // the location of the compressed page in the file
+    short capacity;  // # bytes reserved for the page in the file
+    short length;    // # bytes of the compressed page. 0 if never written
+  };
+  int     mfd;      // file descriptor of the page map. -1 if not compressed
+  int     dataEnd;  // the end of the compressed pages in the file
+  PageId  mapDirty; // the first page whose extent is not written yet
+  std::vector<Extent> extents;  // the extent of every page
+
+  std::string freeName;          // the name of the free list file
+  std::set<PageId> freePages;    // the pages on the free list
+  bool    freeDirty;             // whether the free list has changed since open()
 
+  //
+  // the following set of members implement LRU caching 
+  //
   static int cacheClock; // clock tick counter for LRU policy
 
   // the actual cache data structure
@@ -107,6 +168,7 @@ class PageFile {
 
   static int readCount;  // total # of page reads 
   static int writeCount; // total # of page writes 
+  static int byteReadCount; // total # of bytes read
 };
   
 #endif // PAGEFILE_H
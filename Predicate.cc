@@ -0,0 +1,210 @@
+/**
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include "Predicate.h"
+
+using std::vector;
+using std::max;
+using std::min;
+
+// check the difference between a tuple value and the value of a condition
+// against the comparator C. an instance is compiled for every comparator
+template <SelCond::Comparator C>
+static bool testDiff(int diff)
+{
+  switch (C) {
+  case SelCond::EQ: return diff == 0;
+  case SelCond::NE: return diff != 0;
+  case SelCond::GT: return diff > 0;
+  case SelCond::LT: return diff < 0;
+  case SelCond::GE: return diff >= 0;
+  case SelCond::LE: return diff <= 0;
+  }
+  return false;
+}
+
+// check whether the conditions on the value leave any value. they are
+// normalized into an interval with open or closed ends, which is empty
+// if its ends cross, or if it holds a single value that NE excludes
+static bool valueRangeEmpty(const vector<SelCond>& cond)
+{
+  const char* low = NULL;    // the lower bound on the value. NULL if none
+  const char* high = NULL;   // the upper bound on the value. NULL if none
+  bool lowOpen = false, highOpen = false;
+
+  for (unsigned i = 0; i < cond.size(); i++) {
+    if (cond[i].attr != 2) continue;
+    const char* v = cond[i].value;
+    SelCond::Comparator comp = cond[i].comp;
+
+    // a tighter bound, or an open one at the same value, replaces the old one
+    if (comp == SelCond::EQ || comp == SelCond::GT || comp == SelCond::GE) {
+      bool open = comp == SelCond::GT;
+      int  diff = low ? strcmp(v, low) : 1;
+      if (diff > 0 || (diff == 0 && open)) { low = v; lowOpen = open; }
+    }
+    if (comp == SelCond::EQ || comp == SelCond::LT || comp == SelCond::LE) {
+      bool open = comp == SelCond::LT;
+      int  diff = high ? strcmp(v, high) : -1;
+      if (diff < 0 || (diff == 0 && open)) { high = v; highOpen = open; }
+    }
+  }
+  if (low == NULL || high == NULL) return false;
+
+  int diff = strcmp(low, high);
+  if (diff > 0 || (diff == 0 && (lowOpen || highOpen))) return true;
+
+  // a single value may still be excluded by NE
+  for (unsigned i = 0; i < cond.size() && diff == 0; i++) {
+    if (cond[i].attr == 2 && cond[i].comp == SelCond::NE && strcmp(cond[i].value, low) == 0) return true;
+  }
+  return false;
+}
+
+Predicate::Predicate(const vector<SelCond>& cond)
+{
+  long long lo = INT_MIN, hi = INT_MAX;
+
+  keyCond = false;
+  for (unsigned i = 0; i < cond.size(); i++) {
+    if (cond[i].attr != 1) continue;
+    long long v = atoi(cond[i].value);
+    keyCond = true;
+
+    switch (cond[i].comp) {
+    case SelCond::EQ: lo = max(lo, v); hi = min(hi, v); break;
+    case SelCond::GT: lo = max(lo, v + 1); break;
+    case SelCond::GE: lo = max(lo, v); break;
+    case SelCond::LT: hi = min(hi, v - 1); break;
+    case SelCond::LE: hi = min(hi, v); break;
+    default: break;
+    }
+  }
+
+  // an excluded end of the interval shrinks it, which may uncover another
+  // excluded end, so repeat until no NE condition is on an end
+  for (bool changed = true; changed && lo <= hi; ) {
+    changed = false;
+    for (unsigned i = 0; i < cond.size(); i++) {
+      if (cond[i].attr != 1 || cond[i].comp != SelCond::NE) continue;
+      long long v = atoi(cond[i].value);
+      if (v == lo) { lo++; changed = true; }
+      else if (v == hi) { hi--; changed = true; }
+    }
+  }
+
+  // the keys excluded inside the interval are checked one by one
+  for (unsigned i = 0; i < cond.size() && lo <= hi; i++) {
+    if (cond[i].attr != 1 || cond[i].comp != SelCond::NE) continue;
+    int v = atoi(cond[i].value);
+    if (v > lo && v < hi) excluded.push_back(v);
+  }
+
+  for (unsigned i = 0; i < cond.size(); i++) {
+    if (cond[i].attr != 2) continue;
+    Term term;
+    term.value = cond[i].value;
+    term.length = strlen(cond[i].value);
+    switch (cond[i].comp) {
+    case SelCond::EQ: term.test = testDiff<SelCond::EQ>; break;
+    case SelCond::NE: term.test = testDiff<SelCond::NE>; break;
+    case SelCond::GT: term.test = testDiff<SelCond::GT>; break;
+    case SelCond::LT: term.test = testDiff<SelCond::LT>; break;
+    case SelCond::GE: term.test = testDiff<SelCond::GE>; break;
+    case SelCond::LE: term.test = testDiff<SelCond::LE>; break;
+    }
+    terms.push_back(term);
+  }
+
+  empty = lo > hi || valueRangeEmpty(cond);
+  if (lo > hi) {
+    // an empty interval that matchKey() rejects every key with
+    lowKey = INT_MAX;
+    highKey = INT_MIN;
+  } else {
+    lowKey = (int)lo;
+    highKey = (int)hi;
+  }
+}
+
+bool Predicate::matchValue(const char* value, int length) const
+{
+  for (unsigned i = 0; i < terms.size(); i++) {
+    // compare as strcmp() does, with a value that is not terminated by zero
+    const Term& t = terms[i];
+    int diff = memcmp(value, t.value, length < t.length ? length : t.length);
+    if (diff == 0) diff = length - t.length;
+    if (!t.test(diff)) return false;
+  }
+  return true;
+}
+
+bool Predicate::matchZone(int minKey, int maxKey) const
+{
+  if (maxKey < lowKey || minKey > highKey) return false;
+
+  // a page holding a single excluded key
+  if (minKey == maxKey) return matchKey(minKey);
+  return true;
+}
+
+void Predicate::filterKeys(TupleBatch& batch) const
+{
+  const int* keys = batch.keys;
+  short* sel = batch.sel;
+  int    n = 0;
+
+  if (empty) {
+    batch.selCount = 0;
+    return;
+  }
+
+  // every position is written and kept only if its key is in the
+  // interval, which a single unsigned comparison checks
+  unsigned span = (unsigned)highKey - (unsigned)lowKey;
+  for (int i = 0; i < batch.count; i++) {
+    sel[n] = i;
+    n += ((unsigned)keys[i] - (unsigned)lowKey <= span);
+  }
+
+  // the excluded keys narrow the selection one at a time
+  for (unsigned k = 0; k < excluded.size(); k++) {
+    int m = 0;
+    for (int j = 0; j < n; j++) {
+      sel[m] = sel[j];
+      m += (keys[sel[j]] != excluded[k]);
+    }
+    n = m;
+  }
+  batch.selCount = n;
+}
+
+void Predicate::filterValues(TupleBatch& batch) const
+{
+  short* sel = batch.sel;
+  int    n = batch.selCount;
+
+  for (unsigned k = 0; k < terms.size(); k++) {
+    const Term& t = terms[k];
+    int m = 0;
+    for (int j = 0; j < n; j++) {
+      int i = sel[j];
+      int length = batch.lengths[i];
+      int diff = memcmp(batch.values[i], t.value, length < t.length ? length : t.length);
+      if (diff == 0) diff = length - t.length;
+      sel[m] = i;
+      m += t.test(diff);
+    }
+    n = m;
+  }
+  batch.selCount = n;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef PREDICATE_H
+#define PREDICATE_H
+
+#include <vector>
+#include "SqlEngine.h"
+#include "TupleBatch.h"
+
+/**
+ * the conditions of a WHERE clause compiled for evaluation on tuples.
+ * the conditions on the key are reduced to an interval [low, high] and
+ * the keys that NE conditions exclude from it. every condition on the
+ * value keeps its string with its length and a comparison function
+ * instantiated for its comparator. no constant is parsed and no
+ * comparator is dispatched per tuple.
+ */
+class Predicate {
+ public:
+  /**
+   * compile the conditions. the conditions must stay alive
+   * as long as the predicate is used.
+   * @param cond[IN] the conditions of the WHERE clause, ANDed together
+   */
+  Predicate(const std::vector<SelCond>& cond);
+
+  /**
+   * @return true if no tuple can meet the conditions. this needs no I/O
+   */
+  bool isEmpty() const { return empty; }
+
+  /**
+   * @return true if there is a condition on the key
+   */
+  bool hasKeyCond() const { return keyCond; }
+
+  /**
+   * @return true if there is a condition on the value
+   */
+  bool hasValueCond() const { return !terms.empty(); }
+
+  /**
+   * @return the smallest key that can meet the conditions
+   */
+  int getLowKey() const { return lowKey; }
+
+  /**
+   * @return the largest key that can meet the conditions
+   */
+  int getHighKey() const { return highKey; }
+
+  /**
+   * check the conditions on the key.
+   * @param key[IN] the key of a tuple
+   * @return true if the key meets them
+   */
+  bool matchKey(int key) const
+  {
+    if (key < lowKey || key > highKey) return false;
+    for (unsigned i = 0; i < excluded.size(); i++) {
+      if (key == excluded[i]) return false;
+    }
+    return true;
+  }
+
+  /**
+   * check the conditions on the value.
+   * @param value[IN] the value of a tuple. it need not be terminated by zero
+   * @param length[IN] the length of the value
+   * @return true if the value meets them
+   */
+  bool matchValue(const char* value, int length) const;
+
+  /**
+   * check whether a page with keys in [minKey, maxKey]
+   * may hold a tuple that meets the conditions on the key.
+   * @param minKey[IN] the smallest key in the page
+   * @param maxKey[IN] the largest key in the page
+   * @return false if no key in the page can meet them
+   */
+  bool matchZone(int minKey, int maxKey) const;
+
+  /**
+   * select the tuples of a batch whose key meets the conditions.
+   * the key array is filtered without a branch per tuple.
+   * @param batch[IN/OUT] the batch. its selection vector is replaced
+   */
+  void filterKeys(TupleBatch& batch) const;
+
+  /**
+   * narrow the selection vector of a batch to the tuples whose value
+   * meets the conditions. the selected values must have been read.
+   * @param batch[IN/OUT] the batch
+   */
+  void filterValues(TupleBatch& batch) const;
+
+ private:
+  // a condition on the value
+  struct Term {
+    const char* value;           // the string to compare to
+    int         length;          // its length
+    bool (*test)(int diff);      // the comparator applied to the difference
+  };
+
+  bool empty;                  // no tuple can meet the conditions
+  bool keyCond;                // there is a condition on the key
+  int  lowKey;                 // the smallest key allowed
+  int  highKey;                // the largest key allowed
+  std::vector<int>  excluded;  // the keys in (lowKey, highKey) excluded by NE
+  std::vector<Term> terms;     // the conditions on the value
+};
+
+#endif // PREDICATE_H
@@ -7,23 +7,78 @@
  * @date 3/24/2008
  */
 
+#include <climits>
 #include "Bruinbase.h"
 #include "RecordFile.h"
+#include "TupleBatch.h"
 
 using std::string;
 
 //
 // helper functions for page manipultation
 //
+// A page stores variable-length records in the following layout:
+//
+// |count|slot 0|slot 1|...|slot n-1|  free space  |record n-1|...|record 0|
+//
+// The first four bytes store # records in the page, with SLOTTED_PAGE in
+// the upper two bytes. A page of the fixed-length format that came before
+// has a bare count there, so a table written in it is rejected by open()
+// with RC_INVALID_FILE_FORMAT instead of being read as garbage. Each slot
+// stores the offset of its record in the page and the length of the value
+// as two shorts. Records are stored from the end of the page toward the
+// slot directory and consist of the key followed by the value (without
+// the terminating zero).
+//
+// A deleted record keeps its slot, so that the rids of the other records
+// do not change, and the slot is marked with the length DELETED.
+//
+// A value of MAX_VALUE_LENGTH bytes or longer is stored in the overflow
+// file instead. Its slot has the length LONG_VALUE, and its record holds
+// the key followed by the offset and the length of the value in the
+// overflow file as two ints. The first page of the overflow file stores
+// the end of its data. The values are packed one after another from the
+// second page on, each spanning as many pages as it needs.
+//
+
+// the length in the slot of a record whose value is in the overflow file
+static const short LONG_VALUE = -1;
+
+// the length in the slot of a deleted record (a tombstone). the slot and
+// the space of the record stay in the page until the table is rewritten
+static const short DELETED = -2;
 
 // compute the pointer to the n'th slot in a page
 static char* slotPtr(char* page, int n);
 
-// read the record in the n'th slot in the page
-static void readSlot(const char* page, int n, int& key, std::string& value);
+// locate the record in the n'th slot in the page without copying the value
+static void locateSlot(const char* page, int n, int& key, const char*& value, int& length);
+
+// write the record to the n'th slot in the page.
+// the n'th slot must be the first empty slot. the value of a long record
+// is already in the overflow file at ovfOffset
+static void writeSlot(char* page, int n, int key, const std::string& value, int ovfOffset);
 
-// write the record to the n'th slot in the page
-static void writeSlot(char* page, int n, int key, const std::string& value);
+// get # bytes the record in the n'th slot takes in the page
+static int getSlotSize(const char* page, int n);
+
+// read the location of a long value from its record
+static void readStub(const char* stub, int& offset, int& length);
+
+// check whether a value is stored in the overflow file
+static bool isLongValue(const std::string& value);
+
+// get # free bytes in the page with n records
+static int getFreeSpace(const char* page, int n);
+
+// get # bytes needed to store the record in a page
+static int getRecordSize(const std::string& value);
+
+// the marker in the upper two bytes of the count of a slotted page
+static const int SLOTTED_PAGE = 0x5350;  // "SP"
+
+// check whether the page is in the slotted format
+static bool isSlottedPage(const char* page);
 
 // get # records stored in the page
 static int getRecordCount(const char* page);
@@ -31,6 +86,12 @@ static int getRecordCount(const char* page);
 // update # records stored in the page
 static void setRecordCount(char* page, int count);
 
+//
+// The zone map (filename.zm) stores the smallest and the largest key
+// of every page of the file as two ints, ZONES_PER_PAGE pages to a page.
+//
+static const int ZONES_PER_PAGE = PageFile::PAGE_SIZE / (2*sizeof(int));
+
 
 //
 // helper functions for RecordId manipulation
@@ -106,20 +167,58 @@ RecordFile::RecordFile()
 {
   erid.pid = 0;
   erid.sid = 0;
+  frid.pid = -1;
+  frid.sid = 0;
+  zoneLoaded = false;
+  zoneDirty = -1;
+  ovfEnd = 0;
 }
 
 RecordFile::RecordFile(const string& filename, char mode)
 {
+  frid.pid = -1;
+  frid.sid = 0;
+  zoneLoaded = false;
+  zoneDirty = -1;
+  ovfEnd = 0;
   open(filename, mode);
 }
 
-RC RecordFile::open(const string& filename, char mode)
+RC RecordFile::open(const string& filename, char mode, bool compress)
 {
   RC   rc;
   char page[PageFile::PAGE_SIZE];
 
   // open the page file
-  if ((rc = pf.open(filename, mode)) < 0) return rc;
+  if ((rc = pf.open(filename, mode, compress)) < 0) return rc;
+
+  // open the zone map. a file without a zone map can still be read,
+  // none of its pages is skipped. when writing, the zone map is kept
+  // in memory and updated for every appended record
+  zoneLoaded = false;
+  zoneDirty = -1;
+  zoneMin.clear();
+  zoneMax.clear();
+  if (zf.open(filename + ".zm", mode) < 0 && (mode == 'w' || mode == 'W')) {
+    pf.close();
+    return RC_FILE_OPEN_FAILED;
+  }
+  if ((mode == 'w' || mode == 'W') && (rc = loadZones()) < 0) {
+    zf.close();
+    pf.close();
+    return rc;
+  }
+
+  // the overflow file is opened when the first long value is read or
+  // appended, so that a scan of the keys never touches it. in 'w' mode,
+  // it is created then if there is none
+  this->mode = mode;
+  ovfName = filename + ".ovf";
+  ovfEnd = 0;
+
+  // no freed page is being refilled yet
+  frid.pid = -1;
+  frid.sid = 0;
   
   //
   // in the rest of this function, we set the end record id
@@ -141,27 +240,54 @@ RC RecordFile::open(const string& filename, char mode)
   if ((rc = pf.read(--erid.pid, page)) < 0) {
     // an error occurred during page read
     erid.pid = erid.sid = 0;
+    zf.close();
     pf.close();
     return rc;
   }
 
-  // get # records in the last page
-  erid.sid = getRecordCount(page);
-  if (erid.sid >= RECORDS_PER_PAGE) {
-    // the last page is full. advance the end record id to the next page.
-    erid.pid++;
-    erid.sid = 0;
+  // a file written in the old fixed-length format cannot be read
+  if (!isSlottedPage(page)) {
+    erid.pid = erid.sid = 0;
+    zf.close();
+    pf.close();
+    return RC_INVALID_FILE_FORMAT;
   }
+
+  // get # records in the last page.
+  // whether the next record fits in the page is checked by append()
+  erid.sid = getRecordCount(page);
   
   return 0;
 }
 
 RC RecordFile::close()
 {
+  RC rc;
+
+  // write the zone map entries updated since open()
+  rc = writeZones();
+  zf.close();
+  zoneLoaded = false;
+  zoneMin.clear();
+  zoneMax.clear();
+
+  // store the end of the data in the first page of the overflow file
+  if (ovfEnd > 0) {
+    if (mode == 'w' || mode == 'W') {
+      char page[PageFile::PAGE_SIZE];
+      memset(page, 0, PageFile::PAGE_SIZE);
+      memcpy(page, &ovfEnd, sizeof(int));
+      if (of.write(0, page) < 0 && rc == 0) rc = RC_FILE_WRITE_FAILED;
+    }
+    of.close();
+    ovfEnd = 0;
+  }
+
   erid.pid = 0;
   erid.sid = 0;
 
-  return pf.close();
+  if (pf.close() < 0) return RC_FILE_CLOSE_FAILED;
+  return rc;
 }
 
 RC RecordFile::read(const RecordId& rid, int& key, string& value) const
@@ -177,8 +303,22 @@ RC RecordFile::read(const RecordId& rid, int& key, string& value) const
   // read the page containing the record
   if ((rc = pf.read(rid.pid, page)) < 0) return rc;
 
+  // check whether the slot holds a record
+  if (rid.sid >= getRecordCount(page)) return RC_NO_SUCH_RECORD;
+
   // read the record from the slot in the page
-  readSlot(page, rid.sid, key, value);
+  const char* ptr;
+  int         length;
+  locateSlot(page, rid.sid, key, ptr, length);
+  if (length == DELETED) return RC_NO_SUCH_RECORD;
+
+  // a long value is read from the overflow file
+  if (length == LONG_VALUE) {
+    int offset;
+    readStub(ptr, offset, length);
+    return readOverflow(offset, length, value);
+  }
+  value.assign(ptr, length);
 
   return 0;
 }
@@ -187,91 +327,616 @@ RC RecordFile::append(int key, const std::string& value, RecordId& rid)
 {
   RC   rc;
   char page[PageFile::PAGE_SIZE];
+  bool refill;
+
+  // the pages freed by remove() are filled before the file grows
+  if ((rc = findFreeSlot(value, page, refill)) < 0) return rc;
+  RecordId& slot = refill ? frid : erid;
 
   // unless we are writing to the the first slot of an empty page,
   // we have to read the page first
-  if (erid.sid > 0) {
+  if (!refill && erid.sid > 0) {
     if ((rc = pf.read(erid.pid, page)) < 0) return rc;
-  } else {
-    // if this is the first slot of an empty page
-    // we can simply initialize the page with zeros
+
+    // if the record does not fit in the rest of the page,
+    // move on to the next page
+    if (erid.sid >= RECORDS_PER_PAGE ||
+        getFreeSpace(page, erid.sid) < getRecordSize(value)) {
+      erid.pid++;
+      erid.sid = 0;
+    }
+  }
+
+  // if this is the first slot of an empty page
+  // we can simply initialize the page with zeros
+  if (slot.sid == 0) {
     memset(page, 0, PageFile::PAGE_SIZE);
   }
+
+  // store a long value in the overflow file first
+  int ovfOffset = -1;
+  if (isLongValue(value) && (rc = appendOverflow(value, ovfOffset)) < 0) return rc;
     
   // write the record to the first empty slot 
-  writeSlot(page, erid.sid, key, value);
+  writeSlot(page, slot.sid, key, value, ovfOffset);
 
   // the first four bytes in the page stores # records in the page.
   // update this number.
-  setRecordCount(page, erid.sid + 1);
+  setRecordCount(page, slot.sid + 1);
 
   // write the page to the disk
-  if ((rc = pf.write(erid.pid, page)) < 0) return rc;
+  if ((rc = pf.write(slot.pid, page)) < 0) return rc;
     
   // we need to output the rid of the record slot
-  rid = erid;
+  rid = slot;
+  updateZone(rid, key);
+
+  // advance the slot by one to the next empty slot.
+  // a freed page is left by findFreeSlot() when it is full
+  if (refill) frid.sid++;
+  else ++erid;
+
+  return 0;
+}
+
+// find room for a record with the value in the pages freed by remove().
+// if there is, refill is set, frid is the slot to write the record to
+// and page holds the content of its page
+RC RecordFile::findFreeSlot(const std::string& value, char* page, bool& refill)
+{
+  RC rc;
+
+  refill = false;
+
+  // stay in the page being refilled while the record fits
+  if (frid.pid >= 0) {
+    if ((rc = pf.read(frid.pid, page)) < 0) return rc;
+    if (frid.sid < RECORDS_PER_PAGE &&
+        getFreeSpace(page, frid.sid) >= getRecordSize(value)) {
+      refill = true;
+      return 0;
+    }
+    frid.pid = -1;
+  }
+
+  // otherwise start over the next page on the free list.
+  // its deleted records are dropped
+  if (pf.getFreePageCount() == 0) return 0;
+  if ((rc = pf.allocPage(frid.pid)) < 0) return rc;
+  frid.sid = 0;
+  refill = true;
+  return 0;
+}
+
+RC RecordFile::appendBatch(const std::vector<int>& keys,
+                           const std::vector<std::string>& values,
+                           std::vector<RecordId>& rids)
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  rids.clear();
+  if (keys.empty()) return 0;
+
+  // unless we start from the first slot of an empty page,
+  // we have to read the last page first
+  if (erid.sid > 0) {
+    if ((rc = pf.read(erid.pid, page)) < 0) return rc;
+  } else {
+    memset(page, 0, PageFile::PAGE_SIZE);
+  }
+
+  for (unsigned i = 0; i < keys.size(); i++) {
+    // if the record does not fit in the rest of the page,
+    // write the page to the disk and move on to the next page
+    if (erid.sid > 0 && (erid.sid >= RECORDS_PER_PAGE ||
+        getFreeSpace(page, erid.sid) < getRecordSize(values[i]))) {
+      if ((rc = pf.write(erid.pid, page)) < 0) return rc;
+      erid.pid++;
+      erid.sid = 0;
+      memset(page, 0, PageFile::PAGE_SIZE);
+    }
+
+    // store a long value in the overflow file first
+    int ovfOffset = -1;
+    if (isLongValue(values[i]) && (rc = appendOverflow(values[i], ovfOffset)) < 0) return rc;
+
+    // write the record to the first empty slot and update # records
+    writeSlot(page, erid.sid, keys[i], values[i], ovfOffset);
+    setRecordCount(page, erid.sid + 1);
+    updateZone(erid, keys[i]);
+    rids.push_back(erid);
+    erid.sid++;
+  }
 
-  // advance the end record id by one to the next empty slot
-  ++erid;
+  // write the last page, which may still have room for more records
+  if ((rc = pf.write(erid.pid, page)) < 0) return rc;
 
   return 0;
 }
 
+RC RecordFile::update(const RecordId& rid, const std::string& value, RecordId& newRid)
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+  int  key, length;
+  const char* ptr;
+
+  if (rid.pid < 0 || rid.sid < 0 || rid >= erid) return RC_INVALID_RID;
+  if ((rc = pf.read(rid.pid, page)) < 0) return rc;
+  if (rid.sid >= getRecordCount(page)) return RC_NO_SUCH_RECORD;
+  locateSlot(page, rid.sid, key, ptr, length);
+  if (length == DELETED) return RC_NO_SUCH_RECORD;
+
+  // if the new record is not larger than the old one, overwrite it in place.
+  // the bytes it does not use any more are reclaimed when the table is rewritten
+  if (getRecordSize(value) - (int)sizeof(int) <= getSlotSize(page, rid.sid)) {
+    short offset, len;
+    memcpy(&offset, slotPtr(page, rid.sid), sizeof(short));
+
+    if (isLongValue(value)) {
+      int ovfOffset, size = value.size();
+      if ((rc = appendOverflow(value, ovfOffset)) < 0) return rc;
+      memcpy(page + offset + sizeof(int), &ovfOffset, sizeof(int));
+      memcpy(page + offset + 2*sizeof(int), &size, sizeof(int));
+      len = LONG_VALUE;
+    } else {
+      memcpy(page + offset + sizeof(int), value.data(), value.size());
+      len = value.size();
+    }
+    memcpy(slotPtr(page, rid.sid) + sizeof(short), &len, sizeof(short));
+    if ((rc = pf.write(rid.pid, page)) < 0) return rc;
+
+    newRid = rid;
+    return 0;
+  }
+
+  // otherwise, append the new record and delete the old one
+  if ((rc = append(key, value, newRid)) < 0) return rc;
+  return remove(rid);
+}
+
+RC RecordFile::remove(const RecordId& rid)
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  if (rid.pid < 0 || rid.sid < 0 || rid >= erid) return RC_INVALID_RID;
+  if ((rc = pf.read(rid.pid, page)) < 0) return rc;
+  if (rid.sid >= getRecordCount(page)) return RC_NO_SUCH_RECORD;
+
+  // mark the slot as deleted. the zone of the page is left as it is,
+  // since it only has to cover the keys in the page
+  short length;
+  char* ptr = slotPtr(page, rid.sid) + sizeof(short);
+  memcpy(&length, ptr, sizeof(short));
+  if (length == DELETED) return RC_NO_SUCH_RECORD;
+  length = DELETED;
+  memcpy(ptr, &length, sizeof(short));
+  if ((rc = pf.write(rid.pid, page)) < 0) return rc;
+
+  // put the page on the free list when its last record is gone.
+  // the last page is kept, since erid points into it
+  if (rid.pid == erid.pid) return 0;
+  int n = getRecordCount(page);
+  for (int sid = 0; sid < n; sid++) {
+    memcpy(&length, slotPtr(page, sid) + sizeof(short), sizeof(short));
+    if (length != DELETED) return 0;
+  }
+  if (rid.pid == frid.pid) frid.pid = -1;
+  return pf.freePage(rid.pid);
+}
+
 const RecordId& RecordFile::endRid() const
 {
   return erid;
 }
 
+RecordFile::Scanner::Scanner(const RecordFile& rf)
+{
+  this->rf = &rf;
+  rid.pid = 0;
+  rid.sid = -1;
+  count = 0;
+}
+
+bool RecordFile::Scanner::atEnd() const
+{
+  // the end record id is (pid, 0) when page pid has no record yet
+  return rid.pid > rf->erid.pid || (rid.pid == rf->erid.pid && rf->erid.sid == 0);
+}
+
+PageId RecordFile::Scanner::getPid() const
+{
+  return rid.pid;
+}
+
+RC RecordFile::Scanner::readPage()
+{
+  RC rc;
+
+  count = 0;
+  rid.sid = -1;
+  if ((rc = rf->pf.read(rid.pid, page)) < 0) return rc;
+  count = getRecordCount(page);
+  return 0;
+}
+
+RC RecordFile::Scanner::readPage(TupleBatch& batch)
+{
+  RC    rc;
+  char* p = batch.pages[batch.pageCount];
+
+  count = 0;
+  rid.sid = -1;
+  if ((rc = rf->pf.read(rid.pid, p)) < 0) return rc;
+  batch.pageCount++;
+
+  // the values stay in the copy of the page held by the batch
+  int n = getRecordCount(p);
+  for (int sid = 0; sid < n; sid++) {
+    int i = batch.count;
+    locateSlot(p, sid, batch.keys[i], batch.values[i], batch.lengths[i]);
+    if (batch.lengths[i] == DELETED) continue;
+    batch.rids[i].pid = rid.pid;
+    batch.rids[i].sid = sid;
+    batch.count++;
+  }
+  return 0;
+}
+
+void RecordFile::Scanner::nextPage()
+{
+  rid.pid++;
+  rid.sid = -1;
+  count = 0;
+}
+
+bool RecordFile::Scanner::next(int& key)
+{
+  const char* value;
+  int length;
+
+  // skip the deleted records
+  while (rid.sid + 1 < count) {
+    locateSlot(page, ++rid.sid, key, value, length);
+    if (length != DELETED) return true;
+  }
+  return false;
+}
+
+RC RecordFile::Scanner::getValue(const char*& value, int& length)
+{
+  RC  rc;
+  int key, offset;
+
+  if (rid.sid < 0 || rid.sid >= count) return RC_INVALID_RID;
+  locateSlot(page, rid.sid, key, value, length);
+  if (length != LONG_VALUE) return 0;
+
+  // a long value is read from the overflow file
+  readStub(value, offset, length);
+  if ((rc = rf->readOverflow(offset, length, longValue)) < 0) return rc;
+  value = longValue.data();
+  length = longValue.size();
+  return 0;
+}
+
+const RecordId& RecordFile::Scanner::getRid() const
+{
+  return rid;
+}
+
+RC RecordFile::readLongValues(TupleBatch& batch) const
+{
+  RC  rc;
+  int offset, length;
+
+  // the values are read first and pointed to afterwards,
+  // since the strings may move while the vector grows
+  batch.longValues.clear();
+  for (int j = 0; j < batch.selCount; j++) {
+    int i = batch.sel[j];
+    if (batch.lengths[i] != LONG_VALUE) continue;
+    readStub(batch.values[i], offset, length);
+    batch.longValues.push_back(string());
+    if ((rc = readOverflow(offset, length, batch.longValues.back())) < 0) return rc;
+  }
+
+  for (int j = 0, k = 0; j < batch.selCount; j++) {
+    int i = batch.sel[j];
+    if (batch.lengths[i] != LONG_VALUE) continue;
+    batch.values[i] = batch.longValues[k].data();
+    batch.lengths[i] = batch.longValues[k].size();
+    k++;
+  }
+  return 0;
+}
+
+RC RecordFile::getZone(PageId pid, int& minKey, int& maxKey)
+{
+  RC rc;
+
+  if (!zoneLoaded && (rc = loadZones()) < 0) return rc;
+  if (pid < 0 || pid >= (int)zoneMin.size()) return RC_INVALID_PID;
+
+  minKey = zoneMin[pid];
+  maxKey = zoneMax[pid];
+  return 0;
+}
+
+RC RecordFile::loadZones()
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  // ignore the entries past the end of the file, which may be left
+  // over from an earlier file of the same name
+  int n = zf.endPid() * ZONES_PER_PAGE;
+  if (n > pf.endPid()) n = pf.endPid();
+
+  zoneMin.resize(n);
+  zoneMax.resize(n);
+  for (int i = 0; i < n; i++) {
+    if (i % ZONES_PER_PAGE == 0 && (rc = zf.read(i / ZONES_PER_PAGE, page)) < 0) return rc;
+    char* ptr = page + (i % ZONES_PER_PAGE) * 2*sizeof(int);
+    memcpy(&zoneMin[i], ptr, sizeof(int));
+    memcpy(&zoneMax[i], ptr + sizeof(int), sizeof(int));
+  }
+
+  zoneLoaded = true;
+  return 0;
+}
+
+RC RecordFile::writeZones()
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  if (zoneDirty < 0) return 0;
+
+  // rewrite the zone map pages from the first updated entry on
+  int n = zoneMin.size();
+  for (int i = zoneDirty - zoneDirty % ZONES_PER_PAGE; i < n; i += ZONES_PER_PAGE) {
+    memset(page, 0, PageFile::PAGE_SIZE);
+    for (int j = i; j < n && j < i + ZONES_PER_PAGE; j++) {
+      char* ptr = page + (j - i) * 2*sizeof(int);
+      memcpy(ptr, &zoneMin[j], sizeof(int));
+      memcpy(ptr + sizeof(int), &zoneMax[j], sizeof(int));
+    }
+    if ((rc = zf.write(i / ZONES_PER_PAGE, page)) < 0) return rc;
+  }
+
+  zoneDirty = -1;
+  return 0;
+}
+
+void RecordFile::updateZone(const RecordId& rid, int key)
+{
+  // the keys of the pages written without a zone map are not known
+  while ((int)zoneMin.size() < rid.pid) {
+    zoneMin.push_back(INT_MIN);
+    zoneMax.push_back(INT_MAX);
+  }
+
+  if ((int)zoneMin.size() == rid.pid) {
+    zoneMin.push_back(rid.sid == 0 ? key : INT_MIN);
+    zoneMax.push_back(rid.sid == 0 ? key : INT_MAX);
+  } else if (rid.sid == 0) {
+    zoneMin[rid.pid] = zoneMax[rid.pid] = key;
+  } else {
+    if (key < zoneMin[rid.pid]) zoneMin[rid.pid] = key;
+    if (key > zoneMax[rid.pid]) zoneMax[rid.pid] = key;
+  }
+
+  if (zoneDirty < 0 || rid.pid < zoneDirty) zoneDirty = rid.pid;
+}
+
+RC RecordFile::openOverflow() const
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  if ((rc = of.open(ovfName, mode)) < 0) return rc;
+
+  // the data of a new overflow file starts at the second page
+  if (of.endPid() == 0) {
+    ovfEnd = PageFile::PAGE_SIZE;
+    return 0;
+  }
+
+  if ((rc = of.read(0, page)) < 0) {
+    of.close();
+    return rc;
+  }
+  memcpy(&ovfEnd, page, sizeof(int));
+  if (ovfEnd < PageFile::PAGE_SIZE) {
+    of.close();
+    ovfEnd = 0;
+    return RC_INVALID_FILE_FORMAT;
+  }
+  return 0;
+}
+
+RC RecordFile::appendOverflow(const string& value, int& offset)
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  if (ovfEnd == 0 && (rc = openOverflow()) < 0) return rc;
+
+  // store the value right after the last value, filling up
+  // the rest of the last page first
+  offset = ovfEnd;
+  for (unsigned done = 0; done < value.size(); ) {
+    PageId pid = ovfEnd / PageFile::PAGE_SIZE;
+    int    pos = ovfEnd % PageFile::PAGE_SIZE;
+    int    n = PageFile::PAGE_SIZE - pos;
+    if (n > (int)(value.size() - done)) n = value.size() - done;
+
+    if (pos > 0) {
+      if ((rc = of.read(pid, page)) < 0) return rc;
+    } else {
+      memset(page, 0, PageFile::PAGE_SIZE);
+    }
+    memcpy(page + pos, value.data() + done, n);
+    if ((rc = of.write(pid, page)) < 0) return rc;
+
+    done += n;
+    ovfEnd += n;
+  }
+  return 0;
+}
+
+RC RecordFile::readOverflow(int offset, int length, string& value) const
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  if (ovfEnd == 0 && (rc = openOverflow()) < 0) return rc;
+  if (offset < PageFile::PAGE_SIZE || length < 0 || offset > ovfEnd - length) {
+    return RC_INVALID_FILE_FORMAT;
+  }
+
+  value.clear();
+  while (length > 0) {
+    int pos = offset % PageFile::PAGE_SIZE;
+    int n = PageFile::PAGE_SIZE - pos;
+    if (n > length) n = length;
+
+    if ((rc = of.read(offset / PageFile::PAGE_SIZE, page)) < 0) return rc;
+    value.append(page + pos, n);
+
+    offset += n;
+    length -= n;
+  }
+  return 0;
+}
+
+static bool isSlottedPage(const char* page)
+{
+  int count;
+
+  memcpy(&count, page, sizeof(int));
+  return (count >> 16) == SLOTTED_PAGE;
+}
+
 static int getRecordCount(const char* page)
 {
   int count;
 
   // the first four bytes of a page contains # records in the page
+  // in the lower two bytes
   memcpy(&count, page, sizeof(int));
-  return count;
+  return count & 0xffff;
 }
 
 static void setRecordCount(char* page, int count)
 {
-  // the first four bytes of a page contains # records in the page
+  // the first four bytes of a page contains # records in the page,
+  // marked as a slotted page
+  count |= SLOTTED_PAGE << 16;
   memcpy(page, &count, sizeof(int));
 }
 
+static int getFreeSpace(const char* page, int n)
+{
+  short offset;
+
+  // records are stored from the end of the page, so the last record
+  // marks the end of the free space
+  if (n == 0) {
+    offset = PageFile::PAGE_SIZE;
+  } else {
+    memcpy(&offset, slotPtr(const_cast<char*>(page), n-1), sizeof(short));
+  }
+
+  // the free space also has to hold the slot of the new record
+  return offset - (sizeof(int) + (n+1)*2*sizeof(short));
+}
+
+static int getRecordSize(const std::string& value)
+{
+  // a record consists of the key and the value, or the location
+  // of the value in the overflow file for a long value
+  if (isLongValue(value)) return 3*sizeof(int);
+  return sizeof(int) + value.size();
+}
+
+static bool isLongValue(const std::string& value)
+{
+  return value.size() >= (unsigned)RecordFile::MAX_VALUE_LENGTH;
+}
+
+static int getSlotSize(const char* page, int n)
+{
+  short offset, end;
+
+  // a record ends where the record of the previous slot starts
+  memcpy(&offset, slotPtr(const_cast<char*>(page), n), sizeof(short));
+  if (n == 0) {
+    end = PageFile::PAGE_SIZE;
+  } else {
+    memcpy(&end, slotPtr(const_cast<char*>(page), n-1), sizeof(short));
+  }
+  return end - offset - sizeof(int);
+}
+
+static void readStub(const char* stub, int& offset, int& length)
+{
+  memcpy(&offset, stub, sizeof(int));
+  memcpy(&length, stub + sizeof(int), sizeof(int));
+}
+
 static char* slotPtr(char* page, int n) 
 {
   // compute the location of the n'th slot in a page.
   // remember that the first four bytes in a page is used to store
-  // # records in the page and each slot consists of an integer and
-  // a string of length MAX_VALUE_LENGTH
-  return (page+sizeof(int)) + (sizeof(int)+RecordFile::MAX_VALUE_LENGTH)*n;
+  // # records in the page and each slot consists of two shorts
+  return (page+sizeof(int)) + 2*sizeof(short)*n;
 }
 
-static void readSlot(const char* page, int n, int& key, std::string& value)
+static void locateSlot(const char* page, int n, int& key, const char*& value, int& length)
 {
+  short offset, len;
+
   // compute the location of the record
   char *ptr = slotPtr(const_cast<char*>(page), n);
+  memcpy(&offset, ptr, sizeof(short));
+  memcpy(&len, ptr + sizeof(short), sizeof(short));
 
-  // read the key 
-  memcpy(&key, ptr, sizeof(int));
-
-  // read the value
-  value.assign(ptr + sizeof(int));
+  // read the key. the value follows the key
+  memcpy(&key, page + offset, sizeof(int));
+  value = page + offset + sizeof(int);
+  length = len;
 }
 
-static void writeSlot(char* page, int n, int key, const std::string& value)
+static void writeSlot(char* page, int n, int key, const std::string& value, int ovfOffset)
 {
-  // compute the location of the record
-  char *ptr = slotPtr(page, n);
+  short offset, length;
 
-  // store the key
-  memcpy(ptr, &key, sizeof(int));
-
-  // store the value. 
-  if ((int)value.size() >= RecordFile::MAX_VALUE_LENGTH) {
-    // when the string is longer than MAX_VALUE_LENGTH, truncate it.
-    memcpy(ptr + sizeof(int), value.c_str(), RecordFile::MAX_VALUE_LENGTH -1);
-    *(ptr + sizeof(int) + RecordFile::MAX_VALUE_LENGTH - 1) = 0;
+  // place the record right before the last record in the page
+  length = getRecordSize(value) - sizeof(int);
+  if (n == 0) {
+    offset = PageFile::PAGE_SIZE;
   } else {
-    strcpy(ptr + sizeof(int), value.c_str());
+    memcpy(&offset, slotPtr(page, n-1), sizeof(short));
   }
+  offset -= sizeof(int) + length;
+
+  // store the key and the value, or the location of a long value
+  memcpy(page + offset, &key, sizeof(int));
+  if (isLongValue(value)) {
+    int size = value.size();
+    memcpy(page + offset + sizeof(int), &ovfOffset, sizeof(int));
+    memcpy(page + offset + 2*sizeof(int), &size, sizeof(int));
+    length = LONG_VALUE;
+  } else {
+    memcpy(page + offset + sizeof(int), value.c_str(), length);
+  }
+
+  // store the location of the record in the slot
+  char *ptr = slotPtr(page, n);
+  memcpy(ptr, &offset, sizeof(short));
+  memcpy(ptr + sizeof(short), &length, sizeof(short));
 }
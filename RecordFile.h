@@ -11,8 +11,11 @@
 #define RECORDFILE_H
 
 #include <string>
+#include <vector>
 #include "PageFile.h"
 
+class TupleBatch;
+
 /**
  * The data structure for pointing to a particular record in a RecordFile.
  * A record id consists of pid (PageId) and sid (the slot number in the page)
@@ -44,13 +47,19 @@ bool operator!= (const RecordId& r1, const RecordId& r2);
 class RecordFile {
  public:
 
-  // maximum length of the value field
+  // maximum length of the value field stored in the page of the record.
+  // a value of MAX_VALUE_LENGTH bytes or longer is stored in the overflow
+  // file filename.ovf, and the record keeps only its location there
   static const int MAX_VALUE_LENGTH = 100;  
 
-  // number of record slots per page
-  static const int RECORDS_PER_PAGE = (PageFile::PAGE_SIZE - sizeof(int))/ (sizeof(int) + MAX_VALUE_LENGTH);  
-    // Note that we subtract sizeof(int) from PAGE_SIZE because the first
-    // four bytes in the page is used to store # records in the page.
+  // maximum number of record slots per page
+  static const int RECORDS_PER_PAGE = (PageFile::PAGE_SIZE - sizeof(int))/ (2*sizeof(short) + sizeof(int));  
+    // Records are variable-length. Every record takes a slot entry
+    // (offset and length of the value) in the slot directory at the
+    // beginning of the page and at least sizeof(int) bytes for the key
+    // at the end of the page. Note that we subtract sizeof(int) from
+    // PAGE_SIZE because the first four bytes in the page is used to
+    // store # records in the page.
 
   RecordFile();
   RecordFile(const std::string& filename, char mode);
@@ -60,9 +69,12 @@ class RecordFile {
    * when opened in 'w' mode, if the file does not exist, it is created.
    * @param filename[IN] the name of the file to open
    * @param mode[IN] 'r' for read, 'w' for write
-   * @return error code. 0 if no error
+   * @param compress[IN] whether to compress the pages of a new file.
+   * see PageFile::open()
+   * @return error code. 0 if no error. RC_INVALID_FILE_FORMAT if the
+   * file was written in the fixed-length page format
    */
-  RC open(const std::string& filename, char mode);
+  RC open(const std::string& filename, char mode, bool compress = false);
 
   /**
    * close the file.
@@ -72,6 +84,8 @@ class RecordFile {
 
   /**
    * read a record from the file. note that every record is a (key, value) pair.
+   * since the number of records in a page varies, RC_NO_SUCH_RECORD is
+   * returned when rid.sid is past the last record of the page rid.pid.
    * @param rid[IN] the id of the record to read
    * @param key[OUT] the record key
    * @param value[OUT] the record valu
@@ -80,7 +94,8 @@ class RecordFile {
   RC read(const RecordId& rid, int& key, std::string& value) const;
 
   /**
-   * append a new record at the end of the file.
+   * append a new record at the end of the file. the pages freed by
+   * remove() are filled first, before the file grows.
    * note that RecordFile does not have write() function.
    * append is the only way to write a record to a RecordFile.
    * @param key[IN] the record key
@@ -90,15 +105,184 @@ class RecordFile {
    */
   RC append(int key, const std::string& value, RecordId& rid);
 
+  /**
+   * append a batch of records at the end of the file, past the pages
+   * freed by remove(), so that the batch stays in one run of pages.
+   * the pages are filled in memory and every page is written once,
+   * instead of reading and writing the last page for every record.
+   * @param keys[IN] the record keys
+   * @param values[IN] the record values. values[i] is the value of keys[i]
+   * @param rids[OUT] the locations of the stored records
+   * @return error code. 0 if no error
+   */
+  RC appendBatch(const std::vector<int>& keys,
+                 const std::vector<std::string>& values,
+                 std::vector<RecordId>& rids);
+
+  /**
+   * replace the value of a record. the record is overwritten in place
+   * if the new value fits in its space. otherwise the record is appended
+   * with the new value as by append() and the old one is deleted.
+   * @param rid[IN] the id of the record to update
+   * @param value[IN] the new value
+   * @param newRid[OUT] the location of the updated record
+   * @return error code. 0 if no error
+   */
+  RC update(const RecordId& rid, const std::string& value, RecordId& newRid);
+
+  /**
+   * delete a record. its slot is kept as a tombstone, so the ids of the
+   * other records do not change. read() returns RC_NO_SUCH_RECORD for a
+   * deleted record and Scanner skips it. a page whose records are all
+   * deleted goes on the free list of the file, unless it is the last
+   * page, and append() fills it again.
+   * @param rid[IN] the id of the record to delete
+   * @return error code. 0 if no error
+   */
+  RC remove(const RecordId& rid);
+
   /**
    * note the +1 part. The rid of the last record is endRid()-1.
    * @return (last record id + 1) of the RecordFile
    */
   const RecordId& endRid() const;
 
+  /**
+   * @return true if the pages of the file are stored compressed
+   */
+  bool isCompressed() const { return pf.isCompressed(); }
+
+  /**
+   * get the smallest and the largest key stored in a page from the
+   * zone map of the file, so that a scan can skip the pages that
+   * cannot hold a matching record. the zone map is kept in the side
+   * file filename.zm and is read on first use.
+   * a page whose keys are not known gets [INT_MIN, INT_MAX].
+   * @param pid[IN] the page to look up
+   * @param minKey[OUT] the smallest key in the page
+   * @param maxKey[OUT] the largest key in the page
+   * @return error code. 0 if no error
+   */
+  RC getZone(PageId pid, int& minKey, int& maxKey);
+
+  /**
+   * read the values of the selected tuples of a batch that are stored
+   * in the overflow file, so that every selected tuple has its value.
+   * @param batch[IN/OUT] a batch filled by Scanner::readPage()
+   * @return error code. 0 if no error
+   */
+  RC readLongValues(TupleBatch& batch) const;
+
+  /**
+   * sequential scan of a RecordFile, one page at a time.
+   * every page is read once and its records are returned as pointers
+   * into the page in memory, without copying the values:
+   *
+   *   for (RecordFile::Scanner sc(rf); !sc.atEnd(); sc.nextPage()) {
+   *     if ((rc = sc.readPage()) < 0) ...
+   *     while (sc.next(key)) {
+   *       if ((rc = sc.getValue(value, length)) < 0) ...
+   *     }
+   *   }
+   *
+   * a page can be skipped by calling nextPage() without readPage().
+   * a scan that never calls getValue() never reads the overflow file.
+   */
+  class Scanner {
+   public:
+    /**
+     * start a scan at the first page of the file.
+     * @param rf[IN] the file to scan. it must stay open during the scan
+     */
+    Scanner(const RecordFile& rf);
+
+    /**
+     * @return true if all pages of the file have been visited
+     */
+    bool atEnd() const;
+
+    /**
+     * @return the id of the current page
+     */
+    PageId getPid() const;
+
+    /**
+     * read the current page into memory.
+     * @return error code. 0 if no error
+     */
+    RC readPage();
+
+    /**
+     * read the current page into the next page of a batch and append
+     * its records to the batch, which must have room for them. the long
+     * values are left in the overflow file. next() returns no record
+     * of the page afterwards.
+     * @param batch[IN/OUT] the batch to append to
+     * @return error code. 0 if no error
+     */
+    RC readPage(TupleBatch& batch);
+
+    /**
+     * move on to the next page of the file.
+     */
+    void nextPage();
+
+    /**
+     * move on to the next record of the page in memory.
+     * deleted records are skipped.
+     * @param key[OUT] the record key
+     * @return false if there is no more record in the page
+     */
+    bool next(int& key);
+
+    /**
+     * get the value of the record last returned by next().
+     * the value is not terminated by zero and stays valid
+     * until the next call to next() or readPage().
+     * @param value[OUT] the record value
+     * @param length[OUT] the length of the value
+     * @return error code. 0 if no error
+     */
+    RC getValue(const char*& value, int& length);
+
+    /**
+     * @return the id of the record last returned by next()
+     */
+    const RecordId& getRid() const;
+
+   private:
+    const RecordFile* rf;   // the file being scanned
+    RecordId rid;           // the current page and the last record returned
+    int      count;         // # records in the page in memory
+    char     page[PageFile::PAGE_SIZE];
+    std::string longValue;  // the last value read from the overflow file
+  };
+
  private:
+  RC   findFreeSlot(const std::string& value, char* page, bool& refill);
+  RC   loadZones();
+  RC   writeZones();
+  void updateZone(const RecordId& rid, int key);
+  RC   openOverflow() const;
+  RC   appendOverflow(const std::string& value, int& offset);
+  RC   readOverflow(int offset, int length, std::string& value) const;
+
   PageFile pf;     // the PageFile used to store the records
   RecordId erid;   // the last record id of the file + 1
+  RecordId frid;   // the next slot of the freed page being refilled. pid < 0 if none
+
+  PageFile zf;                // the zone map of the file
+  bool     zoneLoaded;        // whether the zone map is in memory
+  PageId   zoneDirty;         // the first page whose zone is not written yet
+  std::vector<int> zoneMin;   // the smallest key of every page
+  std::vector<int> zoneMax;   // the largest key of every page
+
+  // the overflow file is opened by the first access to a long value,
+  // which may be a read through a const RecordFile
+  mutable PageFile of;   // the overflow file of the long values
+  std::string ovfName;   // the name of the overflow file
+  char        mode;      // the mode the file was opened in
+  mutable int ovfEnd;    // the end of the data in the overflow file. 0 if not open
 };
 
 #endif // RECORDFILE_H
@@ -0,0 +1,238 @@
+/**
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "RecordFile.h"
+#include "SSTable.h"
+
+using std::string;
+using std::vector;
+
+//
+// An SSTable file is laid out as
+//
+//   [data block 0] ... [data block n-1] [block index] [footer]
+//
+// Every data block starts with the # bytes used in the block (a short),
+// followed by the tuples as (key, length of the value, value) with a
+// one-byte length. A tuple never spans two blocks. The block index holds
+// the largest key of every block, and the footer holds SSTABLE_MAGIC,
+// # blocks and # tuples as ints.
+//
+
+static const int SSTABLE_MAGIC = 0x53535431;   // "SST1"
+static const int BLOCK_HEADER_SIZE = sizeof(short);
+static const int FOOTER_SIZE = 3 * sizeof(int);
+
+int SSTable::blockReadCount = 0;
+
+// get # bytes used in a data block
+static int getUsedBytes(const char* block);
+
+// get # bytes a tuple takes in a data block
+static int getTupleSize(int length);
+
+
+SSTable::SSTable()
+{
+  fd = -1;
+  data = NULL;
+  size = blockCount = tupleCount = 0;
+  lastKeys = NULL;
+}
+
+SSTable::~SSTable()
+{
+  if (fd >= 0) close();
+}
+
+RC SSTable::build(const string& filename, const vector<int>& keys, const vector<string>& values)
+{
+  FILE* fp;
+  char  block[BLOCK_SIZE];
+  short used = BLOCK_HEADER_SIZE;
+  vector<int> lastKeys;
+  RC    rc = 0;
+
+  if ((fp = fopen(filename.c_str(), "wb")) == NULL) return RC_FILE_OPEN_FAILED;
+
+  memset(block, 0, BLOCK_SIZE);
+  for (unsigned i = 0; i < keys.size(); i++) {
+    // values longer than MAX_VALUE_LENGTH-1 are truncated as in RecordFile
+    int length = values[i].size();
+    if (length >= RecordFile::MAX_VALUE_LENGTH) length = RecordFile::MAX_VALUE_LENGTH - 1;
+
+    // write out the block when the tuple does not fit in its rest
+    if (used + getTupleSize(length) > BLOCK_SIZE) {
+      memcpy(block, &used, sizeof(short));
+      if (fwrite(block, BLOCK_SIZE, 1, fp) != 1) { rc = RC_FILE_WRITE_FAILED; goto exit_build; }
+      lastKeys.push_back(keys[i-1]);
+      memset(block, 0, BLOCK_SIZE);
+      used = BLOCK_HEADER_SIZE;
+    }
+
+    memcpy(block + used, &keys[i], sizeof(int));
+    block[used + sizeof(int)] = (unsigned char)length;
+    memcpy(block + used + sizeof(int) + 1, values[i].data(), length);
+    used += getTupleSize(length);
+  }
+  if (used > BLOCK_HEADER_SIZE) {
+    memcpy(block, &used, sizeof(short));
+    if (fwrite(block, BLOCK_SIZE, 1, fp) != 1) { rc = RC_FILE_WRITE_FAILED; goto exit_build; }
+    lastKeys.push_back(keys.back());
+  }
+
+  // write the block index and the footer
+  {
+    int footer[3] = { SSTABLE_MAGIC, (int)lastKeys.size(), (int)keys.size() };
+    if (!lastKeys.empty() && fwrite(&lastKeys[0], sizeof(int), lastKeys.size(), fp) != lastKeys.size()) {
+      rc = RC_FILE_WRITE_FAILED;
+      goto exit_build;
+    }
+    if (fwrite(footer, FOOTER_SIZE, 1, fp) != 1) rc = RC_FILE_WRITE_FAILED;
+  }
+
+  exit_build:
+  if (fclose(fp) != 0 && rc == 0) rc = RC_FILE_WRITE_FAILED;
+  return rc;
+}
+
+RC SSTable::open(const string& filename)
+{
+  struct stat statbuf;
+  int    footer[3];
+
+  if (fd >= 0) return RC_FILE_OPEN_FAILED;
+
+  fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) { fd = -1; return RC_FILE_OPEN_FAILED; }
+  if (::fstat(fd, &statbuf) < 0 || statbuf.st_size < FOOTER_SIZE) {
+    ::close(fd);
+    fd = -1;
+    return RC_INVALID_FILE_FORMAT;
+  }
+  size = statbuf.st_size;
+
+  // the whole file is mapped. the pages of the data blocks are brought
+  // in by the operating system when they are first touched
+  void* p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    ::close(fd);
+    fd = -1;
+    return RC_FILE_OPEN_FAILED;
+  }
+  data = (const char*)p;
+
+  // check the footer against the size of the file
+  memcpy(footer, data + size - FOOTER_SIZE, FOOTER_SIZE);
+  blockCount = footer[1];
+  tupleCount = footer[2];
+  if (footer[0] != SSTABLE_MAGIC || blockCount < 0 ||
+      (off_t)blockCount * (BLOCK_SIZE + (int)sizeof(int)) + FOOTER_SIZE != size) {
+    close();
+    return RC_INVALID_FILE_FORMAT;
+  }
+  lastKeys = (const int*)(data + (off_t)blockCount * BLOCK_SIZE);
+
+  return 0;
+}
+
+RC SSTable::close()
+{
+  if (fd < 0) return RC_FILE_CLOSE_FAILED;
+
+  munmap((void*)data, size);
+  ::close(fd);
+
+  fd = -1;
+  data = NULL;
+  size = blockCount = tupleCount = 0;
+  lastKeys = NULL;
+  return 0;
+}
+
+int SSTable::getTupleCount() const
+{
+  return tupleCount;
+}
+
+RC SSTable::locate(int searchKey, SSTableCursor& cursor)
+{
+  if (fd < 0) return RC_INVALID_CURSOR;
+
+  // binary search on the block index for the first block
+  // whose largest key is larger than or equal to searchKey
+  int low = 0, high = blockCount;
+  while (low < high) {
+    int mid = (low + high) / 2;
+    if (lastKeys[mid] < searchKey) low = mid + 1;
+    else high = mid;
+  }
+  cursor.block = low;
+  cursor.offset = 0;
+  if (low == blockCount) return 0;
+
+  // read the block and skip its tuples with smaller keys
+  const char* block = data + (off_t)low * BLOCK_SIZE;
+  int used = getUsedBytes(block);
+  int offset = BLOCK_HEADER_SIZE;
+  blockReadCount++;
+  while (offset < used) {
+    int key;
+    memcpy(&key, block + offset, sizeof(int));
+    if (key >= searchKey) break;
+    offset += getTupleSize((unsigned char)block[offset + sizeof(int)]);
+  }
+  cursor.offset = offset;
+  return 0;
+}
+
+RC SSTable::readForward(SSTableCursor& cursor, int& key, const char*& value, int& length)
+{
+  if (fd < 0) return RC_INVALID_CURSOR;
+
+  while (cursor.block < blockCount) {
+    const char* block = data + (off_t)cursor.block * BLOCK_SIZE;
+
+    // count the block as read when the cursor enters it
+    if (cursor.offset == 0) {
+      blockReadCount++;
+      cursor.offset = BLOCK_HEADER_SIZE;
+    }
+
+    if (cursor.offset < getUsedBytes(block)) {
+      memcpy(&key, block + cursor.offset, sizeof(int));
+      length = (unsigned char)block[cursor.offset + sizeof(int)];
+      value = block + cursor.offset + sizeof(int) + 1;
+      cursor.offset += getTupleSize(length);
+      return 0;
+    }
+
+    // move on to the next block
+    cursor.block++;
+    cursor.offset = 0;
+  }
+  return RC_END_OF_TREE;
+}
+
+static int getUsedBytes(const char* block)
+{
+  short used;
+  memcpy(&used, block, sizeof(short));
+  return used;
+}
+
+static int getTupleSize(int length)
+{
+  return sizeof(int) + 1 + length;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef SSTABLE_H
+#define SSTABLE_H
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "Bruinbase.h"
+#include "PageFile.h"
+
+/**
+ * The position of a tuple in an SSTable.
+ * offset 0 means that the block has not been read yet.
+ */
+typedef struct {
+  int block;   // the data block of the tuple. the first block is 0
+  int offset;  // the location of the tuple in the block
+} SSTableCursor;
+
+/**
+ * an immutable table sorted by key (sorted string table).
+ * the file holds the tuples packed into data blocks of BLOCK_SIZE bytes,
+ * followed by the largest key of every block (the block index) and a
+ * footer. the file is mapped into memory and the block index is searched
+ * there, so a lookup reads only the data blocks holding matching tuples.
+ * an SSTable is written once by build() and never updated in place.
+ */
+class SSTable {
+ public:
+
+  static const int BLOCK_SIZE = PageFile::PAGE_SIZE;  // the size of a data block
+
+  SSTable();
+  ~SSTable();
+
+  /**
+   * write an SSTable file. the tuples must be sorted by key.
+   * values longer than RecordFile::MAX_VALUE_LENGTH-1 are truncated.
+   * @param filename[IN] the name of the file. an existing file is overwritten
+   * @param keys[IN] the keys of the tuples in ascending order
+   * @param values[IN] the values of the tuples. values[i] is the value of keys[i]
+   * @return error code. 0 if no error
+   */
+  static RC build(const std::string& filename,
+                  const std::vector<int>& keys,
+                  const std::vector<std::string>& values);
+
+  /**
+   * map an SSTable file into memory for reading.
+   * @param filename[IN] the name of the file
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& filename);
+
+  /**
+   * unmap the file.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * @return # tuples in the table
+   */
+  int getTupleCount() const;
+
+  /**
+   * find the first tuple whose key is larger than or equal to searchKey,
+   * and output its position in cursor. only the block of the tuple
+   * is read.
+   * @param searchKey[IN] the key to find
+   * @param cursor[OUT] the position of the first tuple with key >= searchKey
+   * @return error code. 0 if no error
+   */
+  RC locate(int searchKey, SSTableCursor& cursor);
+
+  /**
+   * read the tuple at cursor and move cursor to the next tuple.
+   * the value is not terminated by zero and points into the mapped file.
+   * @param cursor[IN/OUT] the position of the tuple to read
+   * @param key[OUT] the key of the tuple
+   * @param value[OUT] the value of the tuple
+   * @param length[OUT] the length of the value
+   * @return RC_END_OF_TREE past the last tuple. 0 if no error
+   */
+  RC readForward(SSTableCursor& cursor, int& key, const char*& value, int& length);
+
+  /**
+   * @return the total # of data blocks read
+   */
+  static int getBlockReadCount() { return blockReadCount; }
+
+ private:
+  int  fd;           // file descriptor of the file. -1 if not open
+  const char* data;  // the mapped file
+  off_t size;        // the size of the file in bytes
+  int  blockCount;   // # data blocks
+  int  tupleCount;   // # tuples
+  const int* lastKeys;  // the block index: the largest key of every block
+
+  static int blockReadCount;  // total # of data block reads
+};
+
+#endif // SSTABLE_H
@@ -8,10 +8,16 @@
  */
 
 #include <cstdio>
+#include <climits>
+#include <cmath>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <map>
 #include "Bruinbase.h"
 #include "SqlEngine.h"
+#include "Predicate.h"
+#include "Operator.h"
 
 using namespace std;
 
@@ -19,218 +25,926 @@ using namespace std;
 extern FILE* sqlin;
 int sqlparse(void);
 
+// # lines of a load file appended to the table in one batch
+static const unsigned LOAD_BATCH_SIZE = 1024;
 
-RC SqlEngine::run(FILE* commandline)
+// the Bloom filters of the tables probed so far, kept in memory
+// so that a probe costs no page reads once the filter is loaded
+static map<string, BloomFilter> filters;
+
+// order (key, rid) pairs by key, and by rid among equal keys
+static bool entryLess(const IndexEntry& e1, const IndexEntry& e2)
 {
-  fprintf(stdout, "Bruinbase> ");
+  if (e1.key != e2.key) return e1.key < e2.key;
+  return e1.rid < e2.rid;
+}
 
-  // set the command line input and start parsing user input
-  sqlin = commandline;
-  sqlparse();  // sqlparse() is defined in SqlParser.tab.c generated from
-               // SqlParser.y by bison (bison is GNU equivalent of yacc)
+// check whether a file of the table exists
+static bool fileExists(const string& filename)
+{
+  PageFile pf;
+  if (pf.open(filename, 'r') < 0) return false;
+  pf.close();
+  return true;
+}
+
+// read the keys of all tuples in a table
+static RC scanKeys(const string& table, vector<int>& keys)
+{
+  RecordFile rf;
+  ColumnFile cf;
+  RC     rc = 0;
+  int    key;
+  const char* value;
+  int    length;
+
+  if (cf.open(table, 'r') == 0) {
+    for (int row = 0; row < cf.getRowCount(); row++) {
+      if ((rc = cf.readKey(row, key)) < 0) break;
+      keys.push_back(key);
+    }
+    cf.close();
+    return rc < 0 ? rc : 0;
+  }
+
+  SSTable sst;
+  if (sst.open(table + ".sst") == 0) {
+    SSTableCursor cursor = { 0, 0 };
+    while (sst.readForward(cursor, key, value, length) == 0) keys.push_back(key);
+    sst.close();
+    return 0;
+  }
+
+  if ((rc = rf.open(table + ".tbl", 'r')) < 0) return rc;
+  for (RecordFile::Scanner sc(rf); !sc.atEnd(); sc.nextPage()) {
+    if ((rc = sc.readPage()) < 0) break;
+    while (sc.next(key)) keys.push_back(key);
+  }
+  rf.close();
+  return rc < 0 ? rc : 0;
+}
 
+// move a file written aside in place of a file of a table
+static RC replaceFile(const string& tmpname, const string& filename)
+{
+  if (rename(tmpname.c_str(), filename.c_str()) < 0) {
+    remove(tmpname.c_str());
+    return RC_FILE_WRITE_FAILED;
+  }
   return 0;
 }
 
-RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
+// rewrite the heap of a row table, sorted by key if sortByKey is set, and
+// build the index on the new heap if buildIndex is set. the new pages are
+// packed and the overflow file keeps only the values of the new heap.
+// the new files are written aside and moved in place only when all of
+// them are complete
+static RC rewriteTable(const string& table, bool sortByKey, bool buildIndex)
+{
+  RecordFile rf;
+  BTreeIndex tree;
+  RC     rc = 0;
+  int    key;
+  const char* value;
+  int    length;
+  bool   compress;
+  vector<string> values;          // the values in the order of the old heap
+  vector<pair<int, int> > order;  // (key, position of the tuple in values)
+  vector<int> keys;
+  vector<string> batch;
+  vector<RecordId> rids;
+  vector<IndexEntry> entries;
+  string tmpname = table + ".tbl.tmp";
+  string idxname = table + ".idx.tmp";
+
+  if ((rc = rf.open(table + ".tbl", 'r')) < 0) return rc;
+  compress = rf.isCompressed();
+  for (RecordFile::Scanner sc(rf); rc == 0 && !sc.atEnd(); sc.nextPage()) {
+    if ((rc = sc.readPage()) < 0) break;
+    while (sc.next(key)) {
+      if ((rc = sc.getValue(value, length)) < 0) break;
+      order.push_back(make_pair(key, (int)values.size()));
+      values.push_back(string(value, length));
+    }
+  }
+  rf.close();
+  if (rc < 0) return rc;
+
+  // tuples with the same key stay in the order of the old heap
+  if (sortByKey) sort(order.begin(), order.end());
+
+  // write the tuples to the new heap a batch at a time
+  remove(tmpname.c_str());
+  remove((tmpname + ".zm").c_str());
+  remove((tmpname + ".pmap").c_str());
+  remove((tmpname + ".ovf").c_str());
+  if ((rc = rf.open(tmpname, 'w', compress)) < 0) return rc;
+  for (unsigned i = 0; i < order.size(); i += LOAD_BATCH_SIZE) {
+    keys.clear();
+    batch.clear();
+    for (unsigned j = i; j < order.size() && j < i + LOAD_BATCH_SIZE; j++) {
+      keys.push_back(order[j].first);
+      batch.push_back(values[order[j].second]);
+    }
+    if ((rc = rf.appendBatch(keys, batch, rids)) < 0) break;
+    for (unsigned j = 0; j < rids.size(); j++) {
+      IndexEntry entry;
+      entry.key = keys[j];
+      entry.rid = rids[j];
+      entries.push_back(entry);
+    }
+  }
+  if (rf.close() < 0 && rc == 0) rc = RC_FILE_CLOSE_FAILED;
+  if (rc < 0) goto rewrite_failed;
+
+  if (buildIndex) {
+    // the rids of a sorted heap grow with the keys,
+    // so the index entries are sorted already
+    if (!sortByKey) sort(entries.begin(), entries.end(), entryLess);
+    remove(idxname.c_str());
+    if ((rc = tree.open(idxname, 'w')) < 0) goto rewrite_failed;
+    rc = tree.bulkLoad(entries);
+    if (tree.close() < 0 && rc == 0) rc = RC_FILE_CLOSE_FAILED;
+    if (rc < 0) goto rewrite_failed;
+  }
+
+  // the old index points into the old heap, so the heap and
+  // the index are replaced together
+  if ((rc = replaceFile(tmpname + ".zm", table + ".tbl.zm")) < 0) goto rewrite_failed;
+  if (compress && (rc = replaceFile(tmpname + ".pmap", table + ".tbl.pmap")) < 0) goto rewrite_failed;
+  if (!fileExists(tmpname + ".ovf")) remove((table + ".tbl.ovf").c_str());
+  else if ((rc = replaceFile(tmpname + ".ovf", table + ".tbl.ovf")) < 0) goto rewrite_failed;
+  if ((rc = replaceFile(tmpname, table + ".tbl")) < 0) goto rewrite_failed;
+  if (buildIndex && (rc = replaceFile(idxname, table + ".idx")) < 0) goto rewrite_failed;
+
+  // the free lists belong to the old files
+  remove((table + ".tbl.free").c_str());
+  if (buildIndex) remove((table + ".idx.free").c_str());
+  return 0;
+
+  rewrite_failed:
+  remove(tmpname.c_str());
+  remove((tmpname + ".zm").c_str());
+  remove((tmpname + ".pmap").c_str());
+  remove((tmpname + ".ovf").c_str());
+  remove(idxname.c_str());
+  return rc;
+}
+
+// report why the row table could not be opened
+static void reportOpenError(const string& table, RC rc)
+{
+  if (rc == RC_INVALID_FILE_FORMAT) {
+    fprintf(stderr, "Error: table %s is in an old page format. load it again\n", table.c_str());
+  } else {
+    fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+  }
+}
+
+// check whether the table exists in a storage format other than the
+// one whose file has the given extension
+static bool otherFormatExists(const string& table, const string& ext)
+{
+  static const char* exts[] = { ".tbl", ".key.col", ".sst", ".part" };
+
+  for (unsigned i = 0; i < sizeof(exts) / sizeof(exts[0]); i++) {
+    if (ext != exts[i] && fileExists(table + exts[i])) return true;
+  }
+  return false;
+}
+
+// build the Bloom filter on the keys of a table, sized for capacity keys,
+// and write it to table.bf
+static RC saveFilter(const string& table, const vector<int>& keys, int capacity)
 {
-  RecordFile rf;   // RecordFile containing the table
-  RecordId   rid;  // record cursor for table scanning
-  BTreeIndex tree; // BTree index for the case that index exists
+  RC rc;
+  BloomFilter filter;
+
+  filter.init(capacity);
+  for (unsigned i = 0; i < keys.size(); i++) filter.insert(keys[i]);
+  if ((rc = filter.save(table + ".bf")) < 0) {
+    remove((table + ".bf").c_str());
+  }
+  return rc;
+}
+
+// load a table stored as an SSTable. the tuples already in the table and
+// those of the load file are sorted together into a new table.sst.tmp,
+// which replaces table.sst when it is complete. the keys of both are
+// added to allKeys
+static RC loadSSTable(const string& table, fstream& fin, vector<int>& allKeys)
+{
+  SSTable sst;
   RC     rc;
-  int    key;     
+  int    key;
+  string line;
   string value;
-  int    count;
-  int    diff;
+  vector<string> values;          // the values in the order they are read
+  vector<pair<int, int> > order;  // (key, position of the tuple in values)
+  vector<int> keys;
+  vector<string> sorted;
+  string tmpname = table + ".sst.tmp";
+
+  // read the tuples already in the table
+  if (sst.open(table + ".sst") == 0) {
+    SSTableCursor cursor = { 0, 0 };
+    const char* v;
+    int len;
+    while (sst.readForward(cursor, key, v, len) == 0) {
+      order.push_back(make_pair(key, (int)values.size()));
+      values.push_back(string(v, len));
+      allKeys.push_back(key);
+    }
+    sst.close();
+  }
+
+  while (getline(fin, line)) {
+    if ((rc = SqlEngine::parseLoadLine(line, key, value)) < 0) return rc;
+    order.push_back(make_pair(key, (int)values.size()));
+    values.push_back(value);
+    allKeys.push_back(key);
+  }
+
+  // tuples with the same key stay in the order they were loaded
+  sort(order.begin(), order.end());
+  for (unsigned i = 0; i < order.size(); i++) {
+    keys.push_back(order[i].first);
+    sorted.push_back(values[order[i].second]);
+  }
 
-  // open the table file
+  if ((rc = SSTable::build(tmpname, keys, sorted)) < 0) {
+    remove(tmpname.c_str());
+    return rc;
+  }
+  return replaceFile(tmpname, table + ".sst");
+}
+
+// build the index of a row or column table. the table is scanned once,
+// its (key, rid) pairs are sorted and the index is built bottom-up into
+// a temporary file, which replaces table.idx only when it is complete
+static RC rebuildIndex(const string& table)
+{
+  RecordFile rf;
+  ColumnFile cf;
+  BTreeIndex tree;
+  RC     rc;
+  int    key;
+  vector<IndexEntry> entries;
+
+  if (cf.open(table, 'r') == 0) {
+    // a column table needs only its key column
+    for (int row = 0; row < cf.getRowCount(); row++) {
+      if ((rc = cf.readKey(row, key)) < 0) {
+        fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+        cf.close();
+        return rc;
+      }
+      IndexEntry entry;
+      entry.key = key;
+      entry.rid.pid = row / ColumnFile::KEYS_PER_PAGE;
+      entry.rid.sid = row % ColumnFile::KEYS_PER_PAGE;
+      entries.push_back(entry);
+    }
+    cf.close();
+  } else {
+    if ((rc = rf.open(table + ".tbl", 'r')) < 0) {
+      reportOpenError(table, rc);
+      return rc;
+    }
+
+    // collect the (key, rid) pairs in a single sequential pass over the table
+    for (RecordFile::Scanner sc(rf); !sc.atEnd(); sc.nextPage()) {
+      if ((rc = sc.readPage()) < 0) {
+        fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+        rf.close();
+        return rc;
+      }
+      while (sc.next(key)) {
+        IndexEntry entry;
+        entry.key = key;
+        entry.rid = sc.getRid();
+        entries.push_back(entry);
+      }
+    }
+    rf.close();
+  }
+  sort(entries.begin(), entries.end(), entryLess);
+
+  // build the index aside and move it in place only when it is complete,
+  // so that concurrent readers see either no index or the whole index
+  string tmpname = table + ".idx.tmp";
+  remove(tmpname.c_str());
+  if ((rc = tree.open(tmpname, 'w')) < 0) return rc;
+  if ((rc = tree.bulkLoad(entries)) < 0) {
+    tree.close();
+    remove(tmpname.c_str());
+    fprintf(stderr, "Error: while building the index on table %s\n", table.c_str());
+    return rc;
+  }
+  if ((rc = tree.close()) < 0) return rc;
+  if (rename(tmpname.c_str(), (table + ".idx").c_str()) < 0) {
+    remove(tmpname.c_str());
+    return RC_FILE_WRITE_FAILED;
+  }
+  remove((table + ".idx.free").c_str());
+  return 0;
+}
+
+// check the equality conditions on the key against the Bloom filter
+// of the table. returns false only if no tuple can match
+static bool filterMatches(const string& table, const vector<SelCond>& cond)
+{
+  map<string, BloomFilter>::iterator it = filters.find(table);
+
+  for (unsigned i = 0; i < cond.size(); i++) {
+    if (cond[i].attr != 1 || cond[i].comp != SelCond::EQ) continue;
+
+    // read the filter on first use. a table without a filter
+    // is looked up as usual
+    if (it == filters.end()) {
+      BloomFilter filter;
+      if (filter.open(table + ".bf") < 0) return true;
+      it = filters.insert(make_pair(table, filter)).first;
+    }
+    if (!it->second.mayContain(atoi(cond[i].value))) return false;
+  }
+  return true;
+}
+
+//
+// A partitioned table has no files of its own but table.part, which holds
+// # bounds followed by the bounds in ascending order as ints. With bounds
+// b0 < b1 < ... < bn-1, partition 0 holds the keys below b0, partition i
+// the keys in [bi-1, bi), and partition n the keys from bn-1 up. Every
+// partition is stored as a table named table.p<i> in any of the formats
+// and is created by the first load of a tuple into it.
+//
+static const int MAX_PARTITION_BOUNDS = PageFile::PAGE_SIZE / sizeof(int) - 1;
+
+// get the name of the i'th partition of a table. a table name
+// in a command cannot contain a dot, so it never clashes with one
+static string partitionName(const string& table, int i)
+{
+  char suffix[16];
+  sprintf(suffix, ".p%d", i);
+  return table + suffix;
+}
+
+// find the partition that holds the key
+static int partitionOf(const vector<int>& bounds, int key)
+{
+  return upper_bound(bounds.begin(), bounds.end(), key) - bounds.begin();
+}
+
+// read the bounds of the partitions of a table from table.part
+static RC readPartitions(const string& table, vector<int>& bounds)
+{
+  PageFile pf;
+  RC   rc;
+  int  n;
+  char page[PageFile::PAGE_SIZE];
+
+  bounds.clear();
+  if ((rc = pf.open(table + ".part", 'r')) < 0) return rc;
+  rc = pf.read(0, page);
+  pf.close();
+  if (rc < 0) return rc;
+
+  memcpy(&n, page, sizeof(int));
+  if (n < 1 || n > MAX_PARTITION_BOUNDS) return RC_INVALID_FILE_FORMAT;
+  bounds.resize(n);
+  memcpy(&bounds[0], page + sizeof(int), n * sizeof(int));
+  return 0;
+}
+
+// write the bounds of the partitions of a table to table.part
+static RC writePartitions(const string& table, const vector<int>& bounds)
+{
+  PageFile pf;
+  RC   rc;
+  int  n = bounds.size();
+  char page[PageFile::PAGE_SIZE];
+
+  memset(page, 0, PageFile::PAGE_SIZE);
+  memcpy(page, &n, sizeof(int));
+  memcpy(page + sizeof(int), &bounds[0], n * sizeof(int));
+
+  if ((rc = pf.open(table + ".part", 'w')) < 0) return rc;
+  if ((rc = pf.write(0, page)) < 0) {
+    pf.close();
+    remove((table + ".part").c_str());
+    return rc;
+  }
+  return pf.close();
+}
+
+// list the tables to run a command with the conditions on. for a
+// partitioned table, these are the partitions that have been loaded and
+// whose key range can hold a key meeting the conditions. the other
+// partitions are pruned without opening any of their files.
+// no table is listed if no tuple can meet the conditions
+static RC findPartitions(const string& table, const Predicate& pred, vector<string>& parts)
+{
+  RC rc;
+  vector<int> bounds;
+
+  parts.clear();
+  if (pred.isEmpty()) return 0;
+  if (!fileExists(table + ".part")) {
+    parts.push_back(table);
+    return 0;
+  }
+  if ((rc = readPartitions(table, bounds)) < 0) {
+    fprintf(stderr, "Error: the partitions of table %s cannot be read\n", table.c_str());
+    return rc;
+  }
+
+  int last = partitionOf(bounds, pred.getHighKey());
+  for (int i = partitionOf(bounds, pred.getLowKey()); i <= last; i++) {
+    // a partition exists once it is stored in any format
+    string name = partitionName(table, i);
+    if (otherFormatExists(name, "")) parts.push_back(name);
+  }
+  return 0;
+}
+
+// run a command on every partition of a partitioned table
+static RC forEachPartition(const string& table, RC (*command)(const string&))
+{
+  RC rc;
+  vector<string> parts;
+
+  if ((rc = findPartitions(table, vector<SelCond>(), parts)) < 0) return rc;
+  for (unsigned i = 0; i < parts.size(); i++) {
+    if ((rc = command(parts[i])) < 0) return rc;
+  }
+  return 0;
+}
+
+// whether the attribute in the SELECT clause needs the values of the
+// tuples. the other ones are computed from the keys alone
+static bool needsValues(int attr)
+{
+  return attr == 2 || attr == 3 || attr == SqlEngine::MIN_VALUE
+      || attr == SqlEngine::MAX_VALUE || attr == SqlEngine::COUNT_DISTINCT_VALUE;
+}
+
+// the access paths of a SELECT on a row table with an index. an index
+// range scan reads the tuples in key order or, if that reads fewer
+// pages, in rid order (see IndexScan)
+enum AccessPath { FULL_SCAN, INDEX_SCAN, INDEX_ONLY_SCAN };
+
+// # leaf nodes of the key range that choosePath() counts the entries of
+static const int PROBE_LEAVES = 4;
+
+// choose the access path of a SELECT on a row table with an index by
+// the estimated # page reads. the # matching tuples is counted in the
+// first PROBE_LEAVES leaves of the key range, and the rest of the range
+// is estimated from the # entries and the key range of the index,
+// assuming evenly spread keys. it is returned in matches with the cost
+// of the chosen path. without index statistics, both are set to -1 and
+// the index is used whenever the conditions bound the key. if the
+// tuples are wanted in key order, a full scan also pays for reading
+// back the runs of the sort when the matches do not fit in its memory
+static AccessPath choosePath(const RecordFile& rf, BTreeIndex& tree, bool needValues,
+                             bool keyOrder, const Predicate& pred, double& matches, double& cost)
+{
+  int  n, low, high, leaves;
+
+  // the key and the aggregates of keys can be answered from the index alone
+  bool indexOnly = !pred.hasValueCond() && !needValues;
+  long long lo = pred.getLowKey(), hi = pred.getHighKey();
+
+  if (tree.getStats(n, low, high, leaves) < 0) {
+    matches = cost = -1;
+    if (lo == INT_MIN && hi == INT_MAX) return FULL_SCAN;
+    return indexOnly ? INDEX_ONLY_SCAN : INDEX_SCAN;
+  }
+
+  int    count, last;
+  bool   complete;
+  double heapPages = rf.endRid().pid + (rf.endRid().sid > 0 ? 1 : 0);
+  double height = tree.getHeight();
+  double probed = 0;  // # leaves read by countRange()
+
+  // the index is not probed if the path to a leaf alone takes as many
+  // reads as a full scan
+  if (lo < low) lo = low;
+  if (hi > high) hi = high;
+  if (n == 0 || lo > hi) {
+    matches = 0;
+  } else if (lo == low && hi == high) {
+    matches = n;
+  } else if (heapPages > height && tree.countRange(lo, hi, PROBE_LEAVES, count, last, complete) == 0) {
+    matches = complete ? count : min((double)n, count + n * ((double)hi - last) / ((double)high - low + 1));
+    probed = PROBE_LEAVES;
+  } else {
+    matches = max(1.0, min((double)n, n * ((double)hi - lo + 1) / ((double)high - low + 1)));
+  }
+
+  // a full scan reads every page of the table. an index scan reads the
+  // path to the first leaf and the leaves of the matching entries, and
+  // then the pages holding the matching tuples, each once in rid order.
+  // the path and the leaves read by the probe are in the cache already
+  double spanned = n > 0 ? max(1.0, ceil(matches * leaves / n)) : 1;
+  double leafReads = probed > 0 ? max(0.0, spanned - probed) : height - 1 + spanned;
+  double fetchReads = heapPages > 0 ? heapPages * (1 - pow(1 - 1 / heapPages, matches)) : 0;
+  double sortPages = n > 0 ? heapPages * matches / n : 0;
+  double sortReads = keyOrder && sortPages * PageFile::PAGE_SIZE > Sort::MEMORY_BUDGET ? sortPages : 0;
+
+  cost = heapPages + sortReads;
+  AccessPath path = FULL_SCAN;
+  if (indexOnly && leafReads < cost) {
+    cost = leafReads;
+    path = INDEX_ONLY_SCAN;
+  }
+  if (!indexOnly && leafReads + fetchReads < cost) {
+    cost = leafReads + fetchReads;
+    path = INDEX_SCAN;
+  }
+  return path;
+}
+
+// report the access path of a SELECT on a row table on stderr
+static void reportPlan(const string& table, const char* path, double matches, double cost)
+{
+  if (matches < 0) {
+    fprintf(stderr, "  -- plan for %s: %s\n", table.c_str(), path);
+  } else {
+    fprintf(stderr, "  -- plan for %s: %s, estimated %.0f tuples in %.0f page reads\n",
+            table.c_str(), path, matches, cost);
+  }
+}
+
+// find the (key, rid) pairs of the tuples of a row table that meet the
+// conditions. with conditions on the key, the index is searched if
+// tree is not NULL. otherwise the table is scanned, skipping the pages
+// that the zone map rules out
+static RC findTuples(RecordFile& rf, BTreeIndex* tree, const Predicate& pred, vector<IndexEntry>& matches)
+{
+  RC        rc;
+  Tuple     tuple;
+  Operator* scan;
+
+  matches.clear();
+  if (tree != NULL && pred.hasKeyCond()) {
+    scan = new IndexScan(*tree, pred.hasValueCond() ? &rf : NULL, pred);
+    if (pred.hasValueCond()) scan = new Filter(scan, pred);
+  } else {
+    scan = new TableScan(rf, pred, false);
+  }
+
+  if ((rc = scan->open()) == 0) {
+    while ((rc = scan->next(tuple)) == 0) {
+      IndexEntry entry;
+      entry.key = tuple.key;
+      entry.rid = tuple.rid;
+      matches.push_back(entry);
+    }
+    if (rc == RC_END_OF_TREE) rc = 0;
+  }
+  scan->close();
+  delete scan;
+  return rc;
+}
+
+// update the value of the tuples of a row table that meet the conditions,
+// or delete them if value is NULL. the tuples are found first and changed
+// afterwards, so that a tuple moved to the end of the table by an update
+// is not visited again. the index is updated along with the table
+static RC changeTuples(const string& table, const char* value, const vector<SelCond>& cond, const Predicate& pred)
+{
+  RecordFile rf;
+  BTreeIndex tree;
+  RC     rc;
+  const char* command = value ? "UPDATE" : "DELETE";
+  vector<IndexEntry> matches;
+
+  if (otherFormatExists(table, ".tbl")) {
+    fprintf(stderr, "Error: %s applies to row tables only\n", command);
+    return RC_INVALID_FILE_FORMAT;
+  }
   if ((rc = rf.open(table + ".tbl", 'r')) < 0) {
-    fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+    reportOpenError(table, rc);
     return rc;
   }
-  // scan the table file from the beginning
-  rid.pid = rid.sid = 0;
-  count = 0;
-  if (tree.open(table + ".idx", 'w') == 0)
-  {
-	  //create key for locate the starting point of the constraint
-	  int minKey = 0;
-	  //creaste cursor for reading forward
-	  IndexCursor cursor;
-	  //find the minimum key to read
-	  for (int i = 0; i < cond.size(); i++)
-	  {
-		  //if the comparison is on key, fin the min requirement; otherwise, skip
-		  if (cond[i].attr == 1)
-		  {
-			  //in the case of Equal, set the minKey to equal value and break
-			  if (cond[i].comp == SelCond::EQ)
-			  {
-				  minKey = atoi(cond[i].value);
-				  break;
-			  }
-			  //in the case of >=, set the minKey to the value of the condition
-			  else if (cond[i].comp == SelCond::GE) minKey = minKey < atoi(cond[i].value) ? atoi(cond[i].value) : minKey;
-			  //in the case of >, set the minKey to the value of the condition with plus one
-			  else if (cond[i].comp == SelCond::GT) minKey = minKey < atoi(cond[i].value) + 1 ? atoi(cond[i].value) + 1 : minKey;
-		  }
-	  }
-	  //locate the position of minimum key, and store it in the cursor
-	  tree.locate(minKey, cursor);
-	  //read forward from the minKey position, and print the tuples satisfying requirement
-	  while (tree.readForward(cursor, key, rid) == 0)
-	  {
-		  // read the tuple, if only count required, not need to read
-		  if (attr != 4)
-		  {
-			  if ((rc = rf.read(rid, key, value)) < 0) {
-				  fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
-				  goto exit_select;
-			  }
-		  }
-
-		  // check the conditions on the tuple
-		  for (unsigned i = 0; i < cond.size(); i++) {
-			  // compute the difference between the tuple value and the condition value
-			  switch (cond[i].attr) {
-			  case 1:
-				  diff = key - atoi(cond[i].value);
-				  break;
-			  case 2:
-				  diff = strcmp(value.c_str(), cond[i].value);
-				  break;
-			  }
-
-			  // skip the tuple if any condition is not met
-			  switch (cond[i].comp) {
-			  case SelCond::EQ:
-				  if (diff != 0) 
-					  if (cond[i].attr == 2) goto next_tuple2;
-					  else goto exit_select;
-				  break;
-			  case SelCond::NE:
-				  if (diff == 0) goto next_tuple2;
-				  break;
-			  case SelCond::GT:
-				  if (diff <= 0) goto next_tuple2;
-				  break;
-			  case SelCond::LT:
-				  if (diff >= 0) 
-					  if (cond[i].attr == 2) goto next_tuple2;
-					  else goto exit_select;
-				  break;
-			  case SelCond::GE:
-				  if (diff < 0) goto next_tuple2;
-				  break;
-			  case SelCond::LE:
-				  if (diff > 0)
-					  if (cond[i].attr == 2) goto next_tuple2;
-					  else goto exit_select;
-				  break;
-			  }
-		  }
-
-		  // the condition is met for the tuple. 
-		  // increase matching tuple counter
-		  count++;
-
-		  // print the tuple 
-		  switch (attr) {
-		  case 1:  // SELECT key
-			  fprintf(stdout, "%d\n", key);
-			  break;
-		  case 2:  // SELECT value
-			  fprintf(stdout, "%s\n", value.c_str());
-			  break;
-		  case 3:  // SELECT *
-			  fprintf(stdout, "%d '%s'\n", key, value.c_str());
-			  break;
-		  }
-
-		  // move to the next tuple
-	  next_tuple2:
-		  continue;
-	  }
-  }
-  else
-  {
-	  while (rid < rf.endRid()) {
-		  // read the tuple
-		  if ((rc = rf.read(rid, key, value)) < 0) {
-			  fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
-			  goto exit_select;
-		  }
-
-		  // check the conditions on the tuple
-		  for (unsigned i = 0; i < cond.size(); i++) {
-			  // compute the difference between the tuple value and the condition value
-			  switch (cond[i].attr) {
-			  case 1:
-				  diff = key - atoi(cond[i].value);
-				  break;
-			  case 2:
-				  diff = strcmp(value.c_str(), cond[i].value);
-				  break;
-			  }
-
-			  // skip the tuple if any condition is not met
-			  switch (cond[i].comp) {
-			  case SelCond::EQ:
-				  if (diff != 0) goto next_tuple;
-				  break;
-			  case SelCond::NE:
-				  if (diff == 0) goto next_tuple;
-				  break;
-			  case SelCond::GT:
-				  if (diff <= 0) goto next_tuple;
-				  break;
-			  case SelCond::LT:
-				  if (diff >= 0) goto next_tuple;
-				  break;
-			  case SelCond::GE:
-				  if (diff < 0) goto next_tuple;
-				  break;
-			  case SelCond::LE:
-				  if (diff > 0) goto next_tuple;
-				  break;
-			  }
-		  }
-
-		  // the condition is met for the tuple. 
-		  // increase matching tuple counter
-		  count++;
-
-		  // print the tuple 
-		  switch (attr) {
-		  case 1:  // SELECT key
-			  fprintf(stdout, "%d\n", key);
-			  break;
-		  case 2:  // SELECT value
-			  fprintf(stdout, "%s\n", value.c_str());
-			  break;
-		  case 3:  // SELECT *
-			  fprintf(stdout, "%d '%s'\n", key, value.c_str());
-			  break;
-		  }
-
-		  // move to the next tuple
-	  next_tuple:
-		  ++rid;
-	  }
-  }
-  // print matching tuple count if "select count(*)"
-  if (attr == 4) {
-    fprintf(stdout, "%d\n", count);
+  rf.close();
+
+  // a key missing from the Bloom filter matches no tuple. deleted keys
+  // stay in the filter, which only makes it answer "maybe" for them
+  if (!filterMatches(table, cond)) return 0;
+
+  if ((rc = rf.open(table + ".tbl", 'w')) < 0) {
+    fprintf(stderr, "Error: while opening table %s\n", table.c_str());
+    return rc;
+  }
+  bool index = fileExists(table + ".idx");
+  if (index && (rc = tree.open(table + ".idx", 'w')) < 0) {
+    fprintf(stderr, "Error: while opening the index of table %s\n", table.c_str());
+    rf.close();
+    return rc;
+  }
+
+  if ((rc = findTuples(rf, index ? &tree : NULL, pred, matches)) < 0) goto change_failed;
+
+  for (unsigned i = 0; i < matches.size(); i++) {
+    const RecordId& rid = matches[i].rid;
+    if (value == NULL) {
+      if ((rc = rf.remove(rid)) < 0) goto change_failed;
+      if (index && (rc = tree.remove(matches[i].key, rid)) < 0) goto change_failed;
+    } else {
+      // a tuple that does not fit in its place any more moves
+      RecordId newRid;
+      if ((rc = rf.update(rid, value, newRid)) < 0) goto change_failed;
+      if (index && newRid != rid) {
+        if ((rc = tree.remove(matches[i].key, rid)) < 0) goto change_failed;
+        if ((rc = tree.insert(matches[i].key, newRid)) < 0) goto change_failed;
+      }
+    }
   }
   rc = 0;
+  goto change_done;
+
+  change_failed:
+  fprintf(stderr, "Error: while running %s on table %s\n", command, table.c_str());
 
-  // close the table file and return
-  exit_select:
+  change_done:
+  if (index) tree.close();
   rf.close();
   return rc;
 }
 
-RC SqlEngine::load(const string& table, const string& loadfile, bool index)
+// print a tuple as requested in the SELECT clause
+static void printTuple(int attr, int key, const char* value, int length)
+{
+  switch (attr) {
+  case 1:  // SELECT key
+    fprintf(stdout, "%d\n", key);
+    break;
+  case 2:  // SELECT value
+    fprintf(stdout, "%.*s\n", length, value);
+    break;
+  case 3:  // SELECT *
+    fprintf(stdout, "%d '%.*s'\n", key, length, value);
+    break;
+  default: // an aggregate, whose result is the value
+    fprintf(stdout, "%.*s\n", length, value);
+    break;
+  }
+}
+
+// the tuples of a single table that meet the conditions of a SELECT.
+// open() opens the files of the table and builds its access path from
+// the scan operators: a column table is read by columns, an SSTable
+// through its block index, and a row table by the path choosePath()
+// picks. a key missing from the Bloom filter matches no tuple,
+// so the table and the index are not read at all then. the smallest
+// or the largest key is read directly from the index when there is one
+class TableSource : public Operator {
+ public:
+  TableSource(int attr, int group, int order, int limit, const string& table,
+              const vector<SelCond>& cond, const Predicate& pred)
+    : attr(attr), group(group), order(order), limit(limit), table(table), cond(cond), pred(pred)
+  {
+    plan = NULL;
+    ordered = false;
+    rfOpen = treeOpen = cfOpen = sstOpen = false;
+  }
+  ~TableSource() { close(); }
+
+  RC open();
+  RC next(Tuple& tuple);
+  RC nextBatch(const TupleBatch*& batch);
+  RC close();
+  bool isOrdered() const { return ordered; }
+
+ private:
+  int         attr;     // the attribute in the SELECT clause
+  int         group;    // the attribute in the GROUP BY clause. 0 if none
+  int         order;    // the attribute in the ORDER BY clause, negated for DESC
+  int         limit;    // # tuples in the LIMIT clause. -1 if none
+  bool        ordered;  // whether the access path returns the tuples in key order
+  string      table;
+  const vector<SelCond>& cond;
+  const Predicate& pred;
+  Operator*   plan;     // the access path. NULL if no tuple can match
+
+  RecordFile  rf;       // the files of the table and whether they are open
+  BTreeIndex  tree;
+  ColumnFile  cf;
+  SSTable     sst;
+  bool        rfOpen, treeOpen, cfOpen, sstOpen;
+};
+
+RC TableSource::open()
+{
+  RC   rc;
+  bool needValues = needsValues(attr) || group == 2 || order == 2 || order == -2;
+  bool probe = (attr == SqlEngine::MIN_KEY || attr == SqlEngine::MAX_KEY) && group == 0
+               && !pred.hasValueCond();
+
+  close();
+  ordered = true;
+  if (!filterMatches(table, cond)) return 0;
+
+  if (cf.open(table, 'r') == 0) {
+    cfOpen = true;
+    treeOpen = tree.open(table + ".idx", 'r') == 0;
+    ordered = treeOpen;
+    if (treeOpen && probe) plan = new KeyProbe(tree, pred, attr == SqlEngine::MAX_KEY);
+    else plan = new ColumnScan(cf, treeOpen ? &tree : NULL, cond, pred, needValues);
+  } else if (sst.open(table + ".sst") == 0) {
+    sstOpen = true;
+    plan = new SSTableScan(sst, pred);
+    if (pred.hasValueCond()) plan = new Filter(plan, pred);
+  } else {
+    if ((rc = rf.open(table + ".tbl", 'r')) < 0) {
+      reportOpenError(table, rc);
+      return rc;
+    }
+    rfOpen = true;
+
+    // choose the access path from the statistics of the index
+    treeOpen = tree.open(table + ".idx", 'r') == 0;
+    // a full scan that returns the tuples in key order also pays for
+    // the runs of its sort, unless the sort keeps the tuples under the
+    // limit in a heap
+    double matches = -1, cost = -1;
+    bool keySort = attr <= 3 && (order == 0 || order == 1);
+    bool keyOrder = keySort && !Sort::fitsHeap(limit);
+    AccessPath path = treeOpen ? choosePath(rf, tree, needValues, keyOrder, pred, matches, cost) : FULL_SCAN;
+
+    if (treeOpen && probe) {
+      reportPlan(table, "index probe", -1, -1);
+      plan = new KeyProbe(tree, pred, attr == SqlEngine::MAX_KEY);
+    } else if (path == FULL_SCAN) {
+      // a table with an index returns its tuples in key order whatever
+      // the access path, so the matches of the scan are sorted first,
+      // and only the first ones are kept under a LIMIT. the order does
+      // not matter to an aggregate or to another ORDER BY
+      reportPlan(table, "full scan", matches, cost);
+      plan = new TableScan(rf, pred, needValues);
+      if (treeOpen && keySort) {
+        plan = new Sort(plan, 1, limit, needValues, table + ".sort");
+      }
+      ordered = plan->isOrdered();
+    } else {
+      // an index-only scan does not read the tuples
+      IndexScan* scan = new IndexScan(tree, path == INDEX_SCAN ? &rf : NULL, pred);
+      plan = scan;
+      if (pred.hasValueCond()) plan = new Filter(plan, pred);
+      if ((rc = plan->open()) < 0) goto open_failed;
+      reportPlan(table, path == INDEX_ONLY_SCAN ? "index-only scan" :
+                 scan->isSorted() ? "index range scan with RID-sorted fetch" : "index range scan", matches, cost);
+      return 0;
+    }
+  }
+
+  if ((rc = plan->open()) == 0) return 0;
+
+  open_failed:
+  fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+  return rc;
+}
+
+RC TableSource::next(Tuple& tuple)
+{
+  RC rc;
+
+  if (plan == NULL) return RC_END_OF_TREE;
+  if ((rc = plan->next(tuple)) < 0 && rc != RC_END_OF_TREE) {
+    fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+  }
+  return rc;
+}
+
+RC TableSource::nextBatch(const TupleBatch*& batch)
+{
+  RC rc;
+
+  if (plan == NULL) return RC_END_OF_TREE;
+  if ((rc = plan->nextBatch(batch)) < 0 && rc != RC_END_OF_TREE) {
+    fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+  }
+  return rc;
+}
+
+RC TableSource::close()
+{
+  if (plan != NULL) {
+    plan->close();
+    delete plan;
+    plan = NULL;
+  }
+  if (rfOpen) rf.close();
+  if (treeOpen) tree.close();
+  if (cfOpen) cf.close();
+  if (sstOpen) sst.close();
+  rfOpen = treeOpen = cfOpen = sstOpen = false;
+  return 0;
+}
+
+RC SqlEngine::run(FILE* commandline)
+{
+  fprintf(stdout, "Bruinbase> ");
+
+  // set the command line input and start parsing user input
+  sqlin = commandline;
+  sqlparse();  // sqlparse() is defined in SqlParser.tab.c generated from
+               // SqlParser.y by bison (bison is GNU equivalent of yacc)
+
+  return 0;
+}
+
+// estimate # groups of a GROUP BY from the statistics of the partitions
+// of a table: # key buckets in the key range of the index and of the
+// conditions, or # tuples. -1 if a partition has no statistics
+static double estimateGroups(const vector<string>& parts, int group, int bucket, const Predicate& pred)
+{
+  double groups = 0;
+
+  for (unsigned i = 0; i < parts.size(); i++) {
+    BTreeIndex tree;
+    ColumnFile cf;
+    SSTable    sst;
+    RecordFile rf;
+    int    n, low, high, leaves;
+    double tuples = -1;
+
+    if (tree.open(parts[i] + ".idx", 'r') == 0) {
+      if (tree.getStats(n, low, high, leaves) == 0) {
+        long long lo = max((long long)low, (long long)pred.getLowKey());
+        long long hi = min((long long)high, (long long)pred.getHighKey());
+        tuples = n;
+        if (group == 1) tuples = lo > hi ? 0 : min(tuples, (double)((hi - lo) / bucket + 1));
+      }
+      tree.close();
+    }
+    if (tuples < 0 && cf.open(parts[i], 'r') == 0) {
+      tuples = cf.getRowCount();
+      cf.close();
+    }
+    if (tuples < 0 && sst.open(parts[i] + ".sst") == 0) {
+      tuples = sst.getTupleCount();
+      sst.close();
+    }
+    if (tuples < 0 && rf.open(parts[i] + ".tbl", 'r') == 0) {
+      tuples = (double)rf.endRid().pid * RecordFile::RECORDS_PER_PAGE + rf.endRid().sid;
+      rf.close();
+    }
+    if (tuples < 0) return -1;
+    groups += tuples;
+  }
+  return groups;
+}
+
+RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond,
+                     int group, int bucket, int order, int limit)
+{
+  RC    rc;
+  Tuple tuple;
+  vector<string> parts;
+  vector<Operator*> sources;
+  Predicate pred(cond);
+
+  // a partitioned table is searched only in the partitions
+  // whose key range meets the conditions on the key
+  if ((rc = findPartitions(table, pred, parts)) < 0) return rc;
+  for (unsigned i = 0; i < parts.size(); i++) {
+    sources.push_back(new TableSource(attr, group, order, limit, parts[i], cond, pred));
+  }
+
+  // the partitions are read one after another in key order. the
+  // matching tuples are grouped for GROUP BY, aggregated for count(*)
+  // and the other aggregate functions, and sorted for ORDER BY and
+  // printed otherwise. ORDER BY key needs no sort if the access paths
+  // return the tuples in key order
+  Operator* plan = new Append(sources);
+  if (group != 0) {
+    double estimate = estimateGroups(parts, group, bucket, pred);
+    plan = new GroupBy(plan, group, bucket, attr, estimate, table + ".grp");
+  } else if (attr >= 4) {
+    plan = new Aggregate(plan, attr);
+  } else if (order != 0) {
+    plan = new Sort(plan, order, limit, attr != 1, table + ".sort");
+    plan = new Project(plan, attr);
+  } else {
+    plan = new Project(plan, attr);
+  }
+  if (limit >= 0) plan = new Limit(plan, limit);
+
+  if ((rc = plan->open()) == 0) {
+    while ((rc = plan->next(tuple)) == 0) {
+      printTuple(attr, tuple.key, tuple.value, tuple.length);
+    }
+    if (rc == RC_END_OF_TREE) rc = 0;
+  }
+  plan->close();
+  delete plan;
+  return rc;
+}
+
+RC SqlEngine::load(const string& table, const string& loadfile, int options)
 {
   /* your code here */
     fstream fin;
@@ -239,36 +953,301 @@ RC SqlEngine::load(const string& table, const string& loadfile, bool index)
         fprintf(stderr, "Error: loadfile %s does not exist\n", loadfile.c_str());
         return -1;
     }
+    // the tuples of a partitioned table go to their partitions
+    if (fileExists(table + ".part")) {
+        fin.close();
+        return loadPartitioned(table, loadfile, options, vector<int>());
+    }
     string line;
     string tablename=table+".tbl";
     RC rc;
     RecordFile rf;
+    ColumnFile cf;
+    // an existing index is kept up to date even without "WITH INDEX"
+    bool index = (options & LOAD_INDEX) != 0 || fileExists(table + ".idx");
+    bool columnar = (options & LOAD_COLUMNAR) != 0;
+    bool compress = (options & LOAD_COMPRESSED) != 0;
+    bool clustered = (options & LOAD_CLUSTERED) != 0;
+    bool sorted = (options & LOAD_SSTABLE) != 0;
+    if (columnar && (compress || clustered)) {
+        fprintf(stderr, "Error: %s applies to row tables only\n", compress ? "COMPRESSED" : "CLUSTERED");
+        return RC_INVALID_FILE_FORMAT;
+    }
+    if (sorted && options != LOAD_SSTABLE) {
+        fprintf(stderr, "Error: SSTABLE takes no other load option\n");
+        return RC_INVALID_FILE_FORMAT;
+    }
+    // a table is stored in one format only
+    if (otherFormatExists(table, sorted ? ".sst" : columnar ? ".key.col" : ".tbl")) {
+        fprintf(stderr, "Error: table %s exists in another format\n", table.c_str());
+        return RC_FILE_OPEN_FAILED;
+    }
+    // an SSTable is rewritten as a whole, and so is its Bloom filter
+    vector<int> allKeys;
+    if (sorted) {
+        rc = loadSSTable(table, fin, allKeys);
+        fin.close();
+        if (rc < 0) {
+            fprintf(stderr, "Error: while loading table %s\n", table.c_str());
+            return rc;
+        }
+        filters.erase(table);
+        return saveFilter(table, allKeys, allKeys.size());
+    }
+    // the Bloom filter of a table that is already there takes the new keys
+    BloomFilter filter;
+    bool existed = fileExists(table + (columnar ? ".key.col" : ".tbl"));
+    bool hasFilter = existed && filter.read(table + ".bf") == 0;
     //SqlEngine se;
-    if ((rc = rf.open(table + ".tbl", 'w')) < 0) {
-        fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+    int format = (options & LOAD_DICTIONARY) ? ColumnFile::DICTIONARY : ColumnFile::PLAIN;
+    if ((rc = columnar ? cf.open(table, 'w', format) : rf.open(table + ".tbl", 'w', compress)) < 0) {
+        if (rc == RC_INVALID_FILE_FORMAT && columnar) {
+            fprintf(stderr, "Error: table %s exists in another format\n", table.c_str());
+        } else {
+            reportOpenError(table, rc);
+        }
         return rc;
     }
+    // drop the Bloom filter until it is rebuilt,
+    // so that a failed load never leaves a filter missing some keys
+    remove((table + ".bf").c_str());
+    filters.erase(table);
 	BTreeIndex tree;
-	if (index)
+	// a clustered table gets its index when it is clustered
+	if (index && !clustered)
 	{
 		if (tree.open(table + ".idx", 'w') < 0) return -1;
 	}
 
     int key;
     string value;
-    RecordId id;
-    while (getline(fin,line)) {
-        if (SqlEngine::parseLoadLine(line,key,value)) return -1;
-        //printf("%d, %s",key,value.c_str());
-        if (rf.append(key,value,id)) return -1;
-		else if (index) tree.insert(key, id);
-    }
-	if (index) tree.close();
+    vector<int> keys;
+    vector<string> values;
+    vector<RecordId> ids;
+    bool eof = false;
+    while (!eof) {
+        // parse up to LOAD_BATCH_SIZE lines and append them in one batch,
+        // so that every page of the table is written once
+        keys.clear();
+        values.clear();
+        while (keys.size() < LOAD_BATCH_SIZE) {
+            if (!getline(fin,line)) {
+                eof = true;
+                break;
+            }
+            if (SqlEngine::parseLoadLine(line,key,value)) return -1;
+            keys.push_back(key);
+            values.push_back(value);
+            allKeys.push_back(key);
+        }
+        if (columnar ? cf.appendBatch(keys,values,ids) : rf.appendBatch(keys,values,ids)) return -1;
+		if (index && !clustered)
+		{
+			for (unsigned i = 0; i < ids.size(); i++) tree.insert(keys[i], ids[i]);
+		}
+    }
+	if (index && !clustered) tree.close();
     fin.close();
-    rf.close();
+    if (columnar) cf.close();
+    else rf.close();
+
+    // add the new keys to the Bloom filter if it has room for them.
+    // otherwise build it on the keys of the whole table, with room for
+    // as many keys again, so that the table is scanned for its keys only
+    // when it has doubled since the last time
+    if (hasFilter && filter.getKeyCount() + allKeys.size() <= (unsigned)filter.getCapacity()) {
+        for (unsigned i = 0; i < allKeys.size(); i++) filter.insert(allKeys[i]);
+        if ((rc = filter.save(table + ".bf")) < 0) {
+            remove((table + ".bf").c_str());
+            return rc;
+        }
+    } else {
+        if (existed) {
+            allKeys.clear();
+            if ((rc = scanKeys(table, allKeys)) < 0) return rc;
+        }
+        if ((rc = saveFilter(table, allKeys, 2 * allKeys.size())) < 0) return rc;
+    }
+
+    // sort the old and the new tuples together. an existing index
+    // is rebuilt, since the tuples move
+    if (clustered && (rc = rewriteTable(table, true, index || fileExists(table + ".idx"))) < 0) {
+        fprintf(stderr, "Error: while clustering table %s\n", table.c_str());
+        return rc;
+    }
     return 0;
 }
 
+RC SqlEngine::loadPartitioned(const string& table, const string& loadfile, int options, const vector<int>& bounds)
+{
+  RC     rc = 0;
+  string line, value;
+  int    key;
+  vector<int>   current;
+  vector<FILE*> files;
+
+  if ((int)bounds.size() > MAX_PARTITION_BOUNDS) {
+    fprintf(stderr, "Error: a table has at most %d partition bounds\n", MAX_PARTITION_BOUNDS);
+    return RC_INVALID_ATTRIBUTE;
+  }
+  for (unsigned i = 1; i < bounds.size(); i++) {
+    if (bounds[i] <= bounds[i-1]) {
+      fprintf(stderr, "Error: partition bounds must be in ascending order\n");
+      return RC_INVALID_ATTRIBUTE;
+    }
+  }
+
+  // the bounds are fixed by the first load. a later load
+  // may leave them out, but must not give other ones
+  if (fileExists(table + ".part")) {
+    if ((rc = readPartitions(table, current)) < 0) {
+      fprintf(stderr, "Error: the partitions of table %s cannot be read\n", table.c_str());
+      return rc;
+    }
+    if (!bounds.empty() && bounds != current) {
+      fprintf(stderr, "Error: table %s is partitioned on other bounds\n", table.c_str());
+      return RC_INVALID_ATTRIBUTE;
+    }
+  } else {
+    if (bounds.empty()) {
+      fprintf(stderr, "Error: table %s is not partitioned\n", table.c_str());
+      return RC_INVALID_ATTRIBUTE;
+    }
+    if (otherFormatExists(table, ".part")) {
+      fprintf(stderr, "Error: table %s exists in another format\n", table.c_str());
+      return RC_FILE_OPEN_FAILED;
+    }
+    current = bounds;
+  }
+
+  fstream fin(loadfile.c_str(), ios::in);
+  if (!fin) {
+    fprintf(stderr, "Error: loadfile %s does not exist\n", loadfile.c_str());
+    return RC_FILE_OPEN_FAILED;
+  }
+  if (!fileExists(table + ".part") && (rc = writePartitions(table, current)) < 0) {
+    fprintf(stderr, "Error: while creating the partitions of table %s\n", table.c_str());
+    return rc;
+  }
+
+  // split the load file into one load file per partition, and load
+  // every partition that gets a tuple as a table of its own. the
+  // other partitions are not touched
+  files.assign(current.size() + 1, (FILE*)NULL);
+  while (getline(fin, line)) {
+    if ((rc = parseLoadLine(line, key, value)) < 0) {
+      fprintf(stderr, "Error: invalid line in loadfile %s\n", loadfile.c_str());
+      goto load_done;
+    }
+    int p = partitionOf(current, key);
+    if (files[p] == NULL &&
+        (files[p] = fopen((partitionName(table, p) + ".load").c_str(), "w")) == NULL) {
+      rc = RC_FILE_OPEN_FAILED;
+      goto load_done;
+    }
+    fprintf(files[p], "%s\n", line.c_str());
+  }
+
+  for (unsigned p = 0; p < files.size(); p++) {
+    if (files[p] == NULL) continue;
+    fclose(files[p]);
+    files[p] = NULL;
+    string name = partitionName(table, p);
+    if (rc == 0) rc = load(name, name + ".load", options);
+  }
+
+  load_done:
+  for (unsigned p = 0; p < files.size(); p++) {
+    if (files[p] != NULL) fclose(files[p]);
+    remove((partitionName(table, p) + ".load").c_str());
+  }
+  fin.close();
+  return rc < 0 ? rc : 0;
+}
+
+RC SqlEngine::createIndex(const string& table)
+{
+  if (fileExists(table + ".part")) return forEachPartition(table, createIndex);
+  if (fileExists(table + ".idx")) {
+    fprintf(stderr, "Error: index on table %s already exists\n", table.c_str());
+    return RC_FILE_OPEN_FAILED;
+  }
+  if (fileExists(table + ".sst")) {
+    fprintf(stderr, "Error: table %s is sorted and needs no index\n", table.c_str());
+    return RC_INVALID_FILE_FORMAT;
+  }
+
+  return rebuildIndex(table);
+}
+
+RC SqlEngine::cluster(const string& table)
+{
+  RC rc;
+
+  if (fileExists(table + ".part")) return forEachPartition(table, cluster);
+  if (otherFormatExists(table, ".tbl")) {
+    fprintf(stderr, "Error: CLUSTER applies to row tables only\n");
+    return RC_INVALID_FILE_FORMAT;
+  }
+  if (!fileExists(table + ".tbl")) {
+    fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+    return RC_FILE_OPEN_FAILED;
+  }
+
+  if ((rc = rewriteTable(table, true, fileExists(table + ".idx"))) < 0) {
+    fprintf(stderr, "Error: while clustering table %s\n", table.c_str());
+  }
+  return rc;
+}
+
+RC SqlEngine::vacuum(const string& table)
+{
+  RC   rc = 0;
+  bool index = fileExists(table + ".idx");
+
+  if (fileExists(table + ".part")) return forEachPartition(table, vacuum);
+  if (fileExists(table + ".tbl")) {
+    if ((rc = rewriteTable(table, false, index)) < 0) {
+      fprintf(stderr, "Error: while vacuuming table %s\n", table.c_str());
+    }
+    return rc;
+  }
+
+  // column tables and SSTables are written packed
+  if (fileExists(table + ".key.col") || fileExists(table + ".sst")) {
+    return index ? rebuildIndex(table) : 0;
+  }
+
+  fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+  return RC_FILE_OPEN_FAILED;
+}
+
+RC SqlEngine::update(const string& table, const string& value, const vector<SelCond>& cond)
+{
+  RC rc;
+  vector<string> parts;
+  Predicate pred(cond);
+
+  if ((rc = findPartitions(table, pred, parts)) < 0) return rc;
+  for (unsigned i = 0; i < parts.size(); i++) {
+    if ((rc = changeTuples(parts[i], value.c_str(), cond, pred)) < 0) return rc;
+  }
+  return 0;
+}
+
+RC SqlEngine::deleteFrom(const string& table, const vector<SelCond>& cond)
+{
+  RC rc;
+  vector<string> parts;
+  Predicate pred(cond);
+
+  if ((rc = findPartitions(table, pred, parts)) < 0) return rc;
+  for (unsigned i = 0; i < parts.size(); i++) {
+    if ((rc = changeTuples(parts[i], NULL, cond, pred)) < 0) return rc;
+  }
+  return 0;
+}
+
 RC SqlEngine::parseLoadLine(const string& line, int& key, string& value)
 {
     const char *s;
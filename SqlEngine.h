@@ -14,6 +14,9 @@
 #include "Bruinbase.h"
 #include "RecordFile.h"
 #include "BTreeIndex.h"
+#include "ColumnFile.h"
+#include "BloomFilter.h"
+#include "SSTable.h"
 
 /**
  * data structure to represent a condition in the WHERE clause
@@ -44,21 +47,131 @@ class SqlEngine {
    * all conditions in conds must be ANDed together.
    * the result of the SELECT is printed on screen.
    * @param attr[IN] attribute in the SELECT clause
-   * (1: key, 2: value, 3: *, 4: count(*))
+   * (1: key, 2: value, 3: *, 4: count(*), or one of the aggregates below)
    * @param table[IN] the table name in the FROM clause
    * @param conds[IN] list of conditions in the WHERE clause
+   * @param group[IN] attribute in the GROUP BY clause (0: none, 1: key,
+   * 2: value). attr is then count(*), or SUM, AVG, MIN or MAX of the key
+   * @param bucket[IN] the width of the key buckets of "GROUP BY key / n"
+   * @param order[IN] attribute in the ORDER BY clause (0: none, 1: key,
+   * 2: value), negated for DESC
+   * @param limit[IN] # tuples in the LIMIT clause. -1 if none
    * @return error code. 0 if no error
    */
-  static RC select(int attr, const std::string& table, const std::vector<SelCond>& conds);
+  static RC select(int attr, const std::string& table, const std::vector<SelCond>& conds,
+                   int group = 0, int bucket = 1, int order = 0, int limit = -1);
+
+  // aggregate functions in the SELECT clause, following 4: count(*)
+  static const int SUM_KEY = 5;                // "sum(key)"
+  static const int AVG_KEY = 6;                // "avg(key)"
+  static const int MIN_KEY = 7;                // "min(key)"
+  static const int MAX_KEY = 8;                // "max(key)"
+  static const int MIN_VALUE = 9;              // "min(value)"
+  static const int MAX_VALUE = 10;             // "max(value)"
+  static const int COUNT_DISTINCT_KEY = 11;    // "count(distinct key)"
+  static const int COUNT_DISTINCT_VALUE = 12;  // "count(distinct value)"
+
+  // options of the LOAD command
+  static const int LOAD_INDEX = 1;     // "WITH INDEX"
+  static const int LOAD_COLUMNAR = 2;  // "COLUMNAR"
+  static const int LOAD_DICTIONARY = 4;  // "DICTIONARY"
+  static const int LOAD_COMPRESSED = 8;  // "COMPRESSED"
+  static const int LOAD_CLUSTERED = 16;  // "CLUSTERED"
+  static const int LOAD_SSTABLE = 32;    // "SSTABLE"
 
   /**
    * load a table from a load file.
+   * with LOAD_COLUMNAR, the table is stored column by column
+   * in table.key.col and table.value.col instead of table.tbl.
+   * with LOAD_DICTIONARY, the value column of the column table is
+   * dictionary-encoded. with LOAD_COMPRESSED, the pages of a new
+   * table.tbl are stored compressed. with LOAD_CLUSTERED, the table
+   * is clustered after the load as cluster() does. with LOAD_SSTABLE,
+   * the table is stored as an immutable SSTable in table.sst, which
+   * every load rewrites with the old and the new tuples.
+   * the tuples of a partitioned table are loaded as loadPartitioned()
+   * does with the bounds of the table.
+   * @param table[IN] the table name in the LOAD command
+   * @param loadfile[IN] the file name of the load file
+   * @param options[IN] LOAD_INDEX, LOAD_COLUMNAR, LOAD_DICTIONARY,
+   * LOAD_COMPRESSED, LOAD_CLUSTERED and LOAD_SSTABLE ORed together
+   * @return error code. 0 if no error
+   */
+  static RC load(const std::string& table, const std::string& loadfile, int options);
+
+  /**
+   * load a table partitioned by ranges of the key. every partition is
+   * stored as a table of its own, table.p<i>, which is loaded from the
+   * tuples of the load file that fall into it with the given options.
+   * with bounds b0 < b1 < ... < bn-1, partition 0 holds the keys below
+   * b0, partition i the keys in [bi-1, bi) and partition n the keys from
+   * bn-1 up. the bounds are stored in table.part by the first load.
+   * SELECT, UPDATE and DELETE visit only the partitions whose key range
+   * meets the conditions on the key, and CREATE INDEX, CLUSTER and
+   * VACUUM work on every partition.
    * @param table[IN] the table name in the LOAD command
    * @param loadfile[IN] the file name of the load file
-   * @param index[IN] true if "WITH INDEX" option was specified
+   * @param options[IN] the load options as in load()
+   * @param bounds[IN] the bounds of the partitions in ascending order.
+   * empty to use the bounds of an already partitioned table
+   * @return error code. 0 if no error
+   */
+  static RC loadPartitioned(const std::string& table, const std::string& loadfile,
+                            int options, const std::vector<int>& bounds);
+
+  /**
+   * build an index on an existing table.
+   * the table is scanned once, its (key, rid) pairs are sorted and the
+   * index is built bottom-up into a temporary file, which replaces
+   * table.idx only when it is complete.
+   * @param table[IN] the table name in the CREATE INDEX command
+   * @return error code. 0 if no error
+   */
+  static RC createIndex(const std::string& table);
+
+  /**
+   * rewrite table.tbl sorted by key and rebuild the index of the table,
+   * so that a range scan of the index reads consecutive pages.
+   * tuples with the same key keep their order. the new table and index
+   * are written aside and replace the old ones only when both are complete.
+   * @param table[IN] the table name in the CLUSTER command
+   * @return error code. 0 if no error
+   */
+  static RC cluster(const std::string& table);
+
+  /**
+   * compact the files of a table. a row table is rewritten in its
+   * current order into packed pages without its deleted tuples, with an overflow file holding only
+   * its values and a rebuilt index. the pages on the free lists of the
+   * old files are dropped. a column table gets its index rebuilt, and an
+   * SSTable is always compact.
+   * @param table[IN] the table name in the VACUUM command
+   * @return error code. 0 if no error
+   */
+  static RC vacuum(const std::string& table);
+
+  /**
+   * executes an UPDATE statement on a row table.
+   * the value of every tuple meeting all conditions is replaced in
+   * place, or the tuple is moved to the end of the table if the new
+   * value does not fit. the index of the table is updated with it.
+   * @param table[IN] the table name in the UPDATE command
+   * @param value[IN] the new value in the SET clause
+   * @param conds[IN] list of conditions in the WHERE clause
+   * @return error code. 0 if no error
+   */
+  static RC update(const std::string& table, const std::string& value, const std::vector<SelCond>& conds);
+
+  /**
+   * executes a DELETE statement on a row table.
+   * every tuple meeting all conditions is marked deleted in its page
+   * and removed from the index of the table. the space of the deleted
+   * tuples is reclaimed by vacuum().
+   * @param table[IN] the table name in the DELETE command
+   * @param conds[IN] list of conditions in the WHERE clause
    * @return error code. 0 if no error
    */
-  static RC load(const std::string& table, const std::string& loadfile, bool index);
+  static RC deleteFrom(const std::string& table, const std::vector<SelCond>& conds);
 
   /**
    * parse a line from the load file into the (key, value) pair.
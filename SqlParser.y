@@ -12,19 +12,72 @@ int  sqllex(void);
 void sqlerror(const char *str) { fprintf(stderr, "Error: %s\n", str); }
 extern "C" { int  sqlwrap() { return 1; } }
 
-static void runSelect(int attr, const char* table, const std::vector<SelCond>& conds)
+static void runSelect(int attr, const char* table, const std::vector<SelCond>& conds,
+                      int group = 0, int bucket = 1, int order = 0, int limit = -1)
 {
   struct tms tmsbuf;
   clock_t btime, etime;
   int     bpagecnt, epagecnt;
+  int     bbytecnt, ebytecnt;
 
+  // an aggregate function that does not apply to the attribute,
+  // a wrong order or a wrong limit
+  if (attr == 0 || order < -2 || order > 2 || limit < -1) return;
+
+  // a data block of an SSTable counts as a page
   btime = times(&tmsbuf);
-  bpagecnt = PageFile::getPageReadCount();
-  SqlEngine::select(attr, table, conds);
+  bpagecnt = PageFile::getPageReadCount() + SSTable::getBlockReadCount();
+  bbytecnt = PageFile::getByteReadCount() + SSTable::getBlockReadCount() * SSTable::BLOCK_SIZE;
+  SqlEngine::select(attr, table, conds, group, bucket, order, limit);
   etime = times(&tmsbuf);
-  epagecnt = PageFile::getPageReadCount();
+  epagecnt = PageFile::getPageReadCount() + SSTable::getBlockReadCount();
+  ebytecnt = PageFile::getByteReadCount() + SSTable::getBlockReadCount() * SSTable::BLOCK_SIZE;
+
+  fprintf(stderr, "  -- %.3f seconds to run the select command. Read %d pages (%d bytes)\n", ((float)(etime - btime))/sysconf(_SC_CLK_TCK), epagecnt - bpagecnt, ebytecnt - bbytecnt);
+}
+
+// the aggregate function of the given name over an attribute
+// (0: *, 1: key, 2: value), as the attribute in the SELECT clause of
+// SqlEngine::select(). function names are not keywords, so that they
+// can still name tables. 0 if there is no such function
+static int aggregate(const char* name, int attr, bool distinct)
+{
+  char msg[64];
+
+  if (strcasecmp(name, "count") == 0) {
+    if (attr == 0) return 4;
+    if (distinct) return attr == 1 ? SqlEngine::COUNT_DISTINCT_KEY : SqlEngine::COUNT_DISTINCT_VALUE;
+  } else if (attr != 0 && !distinct) {
+    if (strcasecmp(name, "min") == 0) return attr == 1 ? SqlEngine::MIN_KEY : SqlEngine::MIN_VALUE;
+    if (strcasecmp(name, "max") == 0) return attr == 1 ? SqlEngine::MAX_KEY : SqlEngine::MAX_VALUE;
+    bool sum = strcasecmp(name, "sum") == 0;
+    if (sum || strcasecmp(name, "avg") == 0) {
+      if (attr == 1) return sum ? SqlEngine::SUM_KEY : SqlEngine::AVG_KEY;
+      snprintf(msg, sizeof(msg), "%.8s() applies to the key only", name);
+      sqlerror(msg);
+      return 0;
+    }
+  }
+  snprintf(msg, sizeof(msg), "wrong aggregate function %.16s()", name);
+  sqlerror(msg);
+  return 0;
+}
 
-  fprintf(stderr, "  -- %.3f seconds to run the select command. Read %d pages\n", ((float)(etime - btime))/sysconf(_SC_CLK_TCK), epagecnt - bpagecnt);
+// run a SELECT with GROUP BY. bucket is the width of the key buckets in
+// the GROUP BY clause, 0 for GROUP BY value, or -1 if it is wrong
+static void runGroupBy(int group, int attr, const char* table, const std::vector<SelCond>& conds, int bucket)
+{
+  if (attr == 0 || bucket < 0) return;
+  if ((group == 2) != (bucket == 0)) {
+    sqlerror("the attribute in the SELECT clause must be the one in the GROUP BY clause");
+    return;
+  }
+  if (attr != 4 && attr != SqlEngine::SUM_KEY && attr != SqlEngine::AVG_KEY &&
+      attr != SqlEngine::MIN_KEY && attr != SqlEngine::MAX_KEY) {
+    sqlerror("GROUP BY takes count(*), or sum(), avg(), min() or max() of the key");
+    return;
+  }
+  runSelect(attr, table, conds, group, bucket == 0 ? 1 : bucket);
 }
 
 %}
@@ -34,17 +87,19 @@ static void runSelect(int attr, const char* table, const std::vector<SelCond>& c
   char* string;
   SelCond* cond;
   std::vector<SelCond>* conds;
+  std::vector<int>* ints;
 }
 
-%token SELECT FROM WHERE LOAD WITH INDEX QUIT COUNT AND OR 
-%token COMMA STAR LF
+%token SELECT FROM WHERE LOAD WITH INDEX CREATE ON COLUMNAR DICTIONARY COMPRESSED CLUSTER CLUSTERED SSTABLE VACUUM UPDATE SET DELETE PARTITION BY RANGE QUIT DISTINCT GROUP ORDER LIMIT AND OR 
+%token COMMA STAR SLASH LPAREN RPAREN LF
 %token <string> INTEGER STRING ID
 %token EQUAL NEQUAL LESS LESSEQUAL GREATER GREATEREQUAL 
 
-%type <integer> attributes attribute comparator
+%type <integer> attributes attribute comparator load_options group_by order_by limit
 %type <string> table value
 %type <cond> condition
 %type <conds> conditions
+%type <ints> bounds
 %%
 
 commands:
@@ -54,6 +109,11 @@ commands:
 
 command:
         load_command { fprintf(stdout, "Bruinbase> "); }
+	| create_command { fprintf(stdout, "Bruinbase> "); }
+	| cluster_command { fprintf(stdout, "Bruinbase> "); }
+	| vacuum_command { fprintf(stdout, "Bruinbase> "); }
+	| update_command { fprintf(stdout, "Bruinbase> "); }
+	| delete_command { fprintf(stdout, "Bruinbase> "); }
 	| select_command { fprintf(stdout, "Bruinbase> "); }
 	| quit_command
 	| error LF { fprintf(stdout, "Bruinbase> "); }
@@ -65,32 +125,165 @@ quit_command:
 	;
 
 load_command:
-	LOAD table FROM STRING LF { 
-	  SqlEngine::load(std::string($2), std::string($4), false); 
+	LOAD table FROM STRING load_options LF { 
+	  SqlEngine::load(std::string($2), std::string($4), $5); 
 	  free($2);
 	  free($4);
 	}
-	| LOAD table FROM STRING WITH INDEX LF { 
-	  SqlEngine::load(std::string($2), std::string($4), true); 
+	| LOAD table FROM STRING PARTITION BY RANGE LPAREN ID RPAREN LPAREN bounds RPAREN load_options LF {
+	  if (strcmp($9, "key") != 0) sqlerror("tables are partitioned by key only");
+	  else SqlEngine::loadPartitioned(std::string($2), std::string($4), $14, *$12);
 	  free($2);
 	  free($4);
+	  free($9);
+	  delete $12;
+	}
+	;
+
+bounds:
+	INTEGER {
+	  $$ = new std::vector<int>;
+	  $$->push_back(atoi($1));
+	  free($1);
+	}
+	| bounds COMMA INTEGER {
+	  $1->push_back(atoi($3));
+	  $$ = $1;
+	  free($3);
+	}
+	;
+
+load_options:
+	load_options WITH INDEX { $$ = $1 | SqlEngine::LOAD_INDEX; }
+	| load_options COLUMNAR { $$ = $1 | SqlEngine::LOAD_COLUMNAR; }
+	| load_options DICTIONARY { $$ = $1 | SqlEngine::LOAD_COLUMNAR | SqlEngine::LOAD_DICTIONARY; }
+	| load_options COMPRESSED { $$ = $1 | SqlEngine::LOAD_COMPRESSED; }
+	| load_options CLUSTERED { $$ = $1 | SqlEngine::LOAD_CLUSTERED; }
+	| load_options SSTABLE { $$ = $1 | SqlEngine::LOAD_SSTABLE; }
+	| { $$ = 0; }
+	;
+
+create_command:
+	CREATE INDEX ON table LF {
+	  SqlEngine::createIndex(std::string($4));
+	  free($4);
+	}
+	;
+
+cluster_command:
+	CLUSTER table LF {
+	  SqlEngine::cluster(std::string($2));
+	  free($2);
+	}
+	;
+
+vacuum_command:
+	VACUUM table LF {
+	  SqlEngine::vacuum(std::string($2));
+	  free($2);
+	}
+	;
+
+update_command:
+	UPDATE table SET attribute EQUAL value LF {
+	  if ($4 != 2) sqlerror("only the value column can be updated");
+	  else SqlEngine::update(std::string($2), std::string($6), std::vector<SelCond>());
+	  free($2);
+	  free($6);
+	}
+	| UPDATE table SET attribute EQUAL value WHERE conditions LF {
+	  if ($4 != 2) sqlerror("only the value column can be updated");
+	  else SqlEngine::update(std::string($2), std::string($6), *$8);
+	  free($2);
+	  free($6);
+	  for (unsigned i = 0; i < $8->size(); i++) {
+	    free((*$8)[i].value);
+	  }
+	  delete $8;
+	}
+	;
+
+delete_command:
+	DELETE FROM table LF {
+	  SqlEngine::deleteFrom(std::string($3), std::vector<SelCond>());
+	  free($3);
+	}
+	| DELETE FROM table WHERE conditions LF {
+	  SqlEngine::deleteFrom(std::string($3), *$5);
+	  free($3);
+	  for (unsigned i = 0; i < $5->size(); i++) {
+	    free((*$5)[i].value);
+	  }
+	  delete $5;
 	}
 	;
 
 select_command:
-	SELECT attributes FROM table LF {
+	SELECT attributes FROM table order_by limit LF {
    	        std::vector<SelCond> conds;
-		runSelect($2, $4, conds);
+		runSelect($2, $4, conds, 0, 1, $5, $6);
 		free($4);
 	}
-	| SELECT attributes FROM table WHERE conditions LF {
-	        runSelect($2, $4, *$6);
+	| SELECT attributes FROM table WHERE conditions order_by limit LF {
+	        runSelect($2, $4, *$6, 0, 1, $7, $8);
 	  	free($4);
 	  	for (unsigned i = 0; i < $6->size(); i++) {
 		    free((*$6)[i].value);
 		}
 	  	delete $6;
 	}
+	| SELECT attribute COMMA attributes FROM table group_by LF {
+	        std::vector<SelCond> conds;
+		runGroupBy($2, $4, $6, conds, $7);
+		free($6);
+	}
+	| SELECT attribute COMMA attributes FROM table WHERE conditions group_by LF {
+	        runGroupBy($2, $4, $6, *$8, $9);
+	  	free($6);
+	  	for (unsigned i = 0; i < $8->size(); i++) {
+		    free((*$8)[i].value);
+		}
+	  	delete $8;
+	}
+	;
+
+order_by:
+	/* empty */ { $$ = 0; }
+	| ORDER BY attribute { $$ = $3 == 1 || $3 == 2 ? $3 : 3; }
+	| ORDER BY attribute ID {
+		/* ASC and DESC are not keywords, so that they can still name tables */
+		$$ = $3 == 1 || $3 == 2 ? $3 : 3;
+		if (strcasecmp($4, "desc") == 0) $$ = -$$;
+		else if (strcasecmp($4, "asc") != 0) {
+			sqlerror("wrong order. neither asc or desc");
+			$$ = 3;
+		}
+		free($4);
+	}
+	;
+
+limit:
+	/* empty */ { $$ = -1; }
+	| LIMIT INTEGER {
+		$$ = atoi($2);
+		if ($$ < 0) {
+			sqlerror("LIMIT takes a number of tuples");
+			$$ = -2;
+		}
+		free($2);
+	}
+	;
+
+group_by:
+	GROUP BY attribute { $$ = $3 == 1 ? 1 : 0; }
+	| GROUP BY attribute SLASH INTEGER {
+		int n = atoi($5);
+		if ($3 != 1 || n <= 0) {
+			sqlerror("only the key can be grouped in buckets of a positive width");
+			$$ = -1;
+		} else $$ = n;
+		free($5);
+	}
 	;
 
 conditions:
@@ -120,7 +313,18 @@ condition:
 attributes:
 	attribute { $$ = $1; }
 	| STAR  { $$ = 3; }
-	| COUNT { $$ = 4; }
+	| ID LPAREN STAR RPAREN {
+		$$ = aggregate($1, 0, false);
+		free($1);
+	}
+	| ID LPAREN attribute RPAREN {
+		$$ = aggregate($1, $3, false);
+		free($1);
+	}
+	| ID LPAREN DISTINCT attribute RPAREN {
+		$$ = aggregate($1, $4, true);
+		free($1);
+	}
 	;
 
 attribute:
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2008 by The Regents of the University of California
+ * Redistribution of this file is permitted under the terms of the GNU
+ * Public License (GPL).
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef TUPLEBATCH_H
+#define TUPLEBATCH_H
+
+#include <string>
+#include <vector>
+#include "PageFile.h"
+#include "RecordFile.h"
+
+/**
+ * a batch of tuples of a row table, laid out by column: the keys in one
+ * array, and the values as pointers into copies of the pages they were
+ * read from, which the batch holds. a batch takes the records of up to
+ * MAX_PAGES whole pages, see RecordFile::Scanner::readPage().
+ *
+ * the selection vector sel holds the positions of the tuples that are
+ * still selected, in ascending order. filters narrow it in place
+ * instead of moving tuples around (see Predicate::filterKeys()).
+ *
+ * a value stored in the overflow file has a negative length until
+ * RecordFile::readLongValues() reads it.
+ */
+class TupleBatch {
+ public:
+  // # pages of records a batch can take
+  static const int MAX_PAGES = 8;
+
+  // # tuples a batch can take
+  static const int CAPACITY = MAX_PAGES * RecordFile::RECORDS_PER_PAGE;
+
+  TupleBatch() { clear(); }
+
+  /**
+   * empty the batch.
+   */
+  void clear() { count = selCount = pageCount = 0; longValues.clear(); }
+
+  /**
+   * @return true if the records of another page fit in the batch
+   */
+  bool hasRoom() const { return pageCount < MAX_PAGES; }
+
+  /**
+   * select every tuple of the batch.
+   */
+  void selectAll()
+  {
+    for (int i = 0; i < count; i++) sel[i] = i;
+    selCount = count;
+  }
+
+  int         count;              // # tuples in the batch
+  int         keys[CAPACITY];     // the keys of the tuples
+  const char* values[CAPACITY];   // the values. not terminated by zero
+  int         lengths[CAPACITY];  // the lengths of the values
+  RecordId    rids[CAPACITY];     // the ids of the records of the tuples
+
+  int         selCount;           // # selected tuples
+  short       sel[CAPACITY];      // the positions of the selected tuples
+
+  int         pageCount;          // # pages read into the batch
+  char        pages[MAX_PAGES][PageFile::PAGE_SIZE];  // the pages read
+  std::vector<std::string> longValues;  // the values read from the overflow file
+};
+
+#endif // TUPLEBATCH_H
@@ -363,8 +363,8 @@ static void yy_fatal_error (yyconst char msg[]  );
 	*yy_cp = '\0'; \
 	(yy_c_buf_p) = yy_cp;
 
-#define YY_NUM_RULES 26
-#define YY_END_OF_BUFFER 27
+#define YY_NUM_RULES 47
+#define YY_END_OF_BUFFER 48
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -372,21 +372,43 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static yyconst flex_int16_t yy_accept[113] =
-    {   0,
-        0,    0,   27,   26,   25,   23,   26,   26,   22,   21,
-       26,   18,   24,   15,   12,   14,   20,   20,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,   25,   23,    0,
-       19,   18,   17,   13,   16,   20,   20,   20,   20,   20,
-       20,   20,   11,   20,   20,   20,   20,   20,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,   10,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,    8,    2,   20,
-        4,    7,   20,   20,    5,   20,   20,   20,   20,   20,
 
-        6,   20,    3,   20,   20,    0,    1,    0,    0,    0,
-        9,    0
+static yyconst flex_int16_t yy_accept[307] =
+    {   0,
+        0,    0,   48,   47,   46,   44,   47,   47,   40,   41,
+       42,   39,   47,   43,   36,   45,   33,   30,   32,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   46,   44,    0,   37,   36,   35,
+       31,   34,   38,   38,   20,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,    8,   29,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   20,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+
+        8,   29,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   28,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       17,   38,   38,   38,   38,   38,   28,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   17,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   23,    2,
+       38,   38,   38,    4,   38,   38,   22,   38,   38,   38,
+       38,   38,   38,    5,   38,   38,   38,   38,   38,   38,
+       38,   23,    2,   38,   38,   38,    4,   38,   38,   22,
+
+       38,   38,   38,   38,   38,   38,    5,   38,   38,   38,
+       38,   38,   38,   38,   25,    6,   27,   26,   38,   21,
+       38,   38,   38,   38,    3,   38,   38,   38,   38,   38,
+       38,   38,   25,    6,   27,   26,   38,   21,   38,   38,
+       38,   38,    3,   38,   38,   38,    7,   18,   38,   38,
+       38,    1,   38,   16,   15,   38,   38,   38,    7,   18,
+       38,   38,   38,    1,   38,   16,   15,   13,   38,   38,
+       38,   38,   38,   14,   13,   38,   38,   38,   38,   38,
+       14,   38,    9,   38,   38,   24,   38,   38,    9,   38,
+       38,   24,   38,   12,   38,   38,   19,   12,   38,   38,
+
+       19,   11,   10,   11,   10,    0
     } ;
 
 static yyconst flex_int32_t yy_ec[256] =
@@ -395,16 +417,16 @@ static yyconst flex_int32_t yy_ec[256] =
         1,    1,    4,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    2,    1,    1,    1,    1,    1,    1,    5,    6,
-        7,    8,    1,    9,   10,    1,    1,   11,   11,   11,
-       11,   11,   11,   11,   11,   11,   11,    1,   12,   13,
-       14,   15,    1,    1,   16,   17,   18,   19,   20,   21,
-       17,   22,   23,   17,   17,   24,   25,   26,   27,   17,
-       28,   29,   30,   31,   32,   17,   33,   34,   17,   17,
-        1,    1,    1,    1,   35,    1,   36,   17,   37,   38,
-
-       39,   40,   17,   41,   42,   17,   17,   43,   44,   45,
-       46,   17,   47,   48,   49,   50,   51,   17,   52,   53,
-       17,   17,    1,    1,    1,    1,    1,    1,    1,    1,
+        7,    8,    1,    9,   10,    1,   11,   12,   12,   12,
+       12,   12,   12,   12,   12,   12,   12,    1,   13,   14,
+       15,   16,    1,    1,   17,   18,   19,   20,   21,   22,
+       23,   24,   25,   26,   26,   27,   28,   29,   30,   31,
+       32,   33,   34,   35,   36,   37,   38,   39,   40,   26,
+        1,    1,    1,    1,   41,    1,   42,   43,   44,   45,
+
+       46,   47,   48,   49,   50,   26,   26,   51,   52,   53,
+       54,   55,   56,   57,   58,   59,   60,   61,   62,   63,
+       64,   26,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
@@ -421,102 +443,208 @@ static yyconst flex_int32_t yy_ec[256] =
         1,    1,    1,    1,    1
     } ;
 
-static yyconst flex_int32_t yy_meta[54] =
+static yyconst flex_int32_t yy_meta[65] =
     {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    2,
-        2,    1,    1,    1,    1,    2,    2,    2,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2,    2
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1
     } ;
 
-static yyconst flex_int16_t yy_base[115] =
+static yyconst flex_int16_t yy_base[307] =
     {   0,
-        0,    0,  144,  145,  141,  145,  139,  136,  145,  145,
-      129,  128,  145,   40,  145,  124,  111,    0,  109,  101,
-      105,  107,  105,  102,   98,  109,   34,   83,   81,   73,
-       77,   79,   77,   74,   70,   81,   17,  117,  145,  113,
-      145,  106,  145,  145,  145,    0,   97,   83,   91,   86,
-       93,   95,    0,   87,   85,   88,   76,   68,   54,   62,
-       57,   64,   65,   58,   56,   59,   47,    0,   70,   64,
-       69,   73,   73,   60,   70,   60,   66,   42,   36,   41,
-       45,   45,   32,   42,   32,   38,   47,    0,    0,   43,
-        0,    0,   58,   55,    0,   24,   20,   35,   32,   64,
-
-        0,   38,    0,   62,   17,   58,    0,   57,   57,   56,
-      145,  145,   59,   60
+        1,    1,    1,    1,   64,    1,   64,   67,    1,    1,
+        1,    1,  120,    1,    1,    1,  118,    1,  120,  126,
+      162,  165,  172,  167,  108,  106,  111,  113,  174,  174,
+      183,  169,  191,  188,  179,  194,  188,  161,  151,  166,
+      175,  153,  161,  162,  171,  176,  174,  186,  169,  190,
+      187,  179,  193,  187,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,  218,    1,  203,  213,  221,  216,  225,
+      221,  217,  218,  229,  222,  234,    1,  232,  220,  229,
+      226,  229,  222,  238,  241,  240,  227,  218,    1,  205,
+      215,  222,  218,  226,  221,  218,  219,  229,  223,  234,
+
+        1,  232,  221,  229,  227,  230,  223,  238,  241,  240,
+      228,    1,  254,  254,  260,  275,  272,  259,  260,  261,
+      269,  262,  278,  275,  281,  281,  268,  269,  282,  285,
+        1,  290,  291,  273,  277,  287,    1,  254,  253,  259,
+      273,  270,  258,  259,  260,  268,  261,  276,  273,  279,
+      279,  267,  268,  280,  283,    1,  288,  289,  272,  276,
+      285,  300,  308,  304,  303,  304,  315,  316,    1,    1,
+      311,  304,  309,    1,  312,  321,    1,  326,  329,  331,
+      315,  315,  331,    1,  294,  302,  298,  297,  298,  308,
+      309,    1,    1,  305,  298,  303,    1,  306,  314,    1,
+
+      319,  322,  324,  309,  309,  324,    1,  350,  343,  352,
+      353,  354,  346,  348,    1,    1,    1,    1,  343,    1,
+      344,  353,  360,  354,    1,  337,  331,  339,  340,  341,
+      334,  336,    1,    1,    1,    1,  331,    1,  332,  341,
+      347,  342,    1,  362,  379,  363,    1,    1,  369,  380,
+      375,    1,  380,    1,    1,  345,  361,  346,    1,    1,
+      352,  362,  357,    1,  362,    1,    1,  388,  377,  377,
+      395,  378,  384,    1,  369,  359,  359,  376,  360,  366,
+        1,  401,    1,  401,  390,    1,  395,  380,    1,  380,
+      370,    1,  375,    1,  409,  390,    1,    1,  386,  368,
+
+        1,    1,    1,    1,    1,  433
     } ;
 
-static yyconst flex_int16_t yy_def[115] =
+static yyconst flex_int16_t yy_def[307] =
     {   0,
-      112,    1,  112,  112,  112,  112,  112,  113,  112,  112,
-      112,  112,  112,  112,  112,  112,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  112,  112,  113,
-      112,  112,  112,  112,  112,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-
-      114,  114,  114,  114,  114,  112,  114,  112,  112,  112,
-      112,    0,  112,  112
+      306,    1,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,   13,  306,  306,  306,  306,  306,
+       20,   20,   20,   20,   20,   25,   20,   20,   27,   20,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,    5,  306,    8,  306,   13,  306,
+      306,  306,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   25,   27,
+       20,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   25,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   25,   27,   27,   27,   27,   27,   27,
+       27,   24,   27,   27,   25,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+
+       27,   27,   27,   27,   27,   27,   27,   27,   20,   27,
+       27,   27,   27,   20,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   25,   27,   27,   27,   27,   20,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   25,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   25,   27,   20,   27,   27,   27,
+       27,   27,   27,   27,   27,   21,   27,   27,   27,   27,
+
+       27,   27,   27,   27,   27,    0
     } ;
 
-static yyconst flex_int16_t yy_nxt[199] =
+static yyconst flex_int16_t yy_nxt[498] =
     {   0,
-        4,    5,    6,    7,    8,    4,    4,    9,   10,   11,
-       12,   13,   14,   15,   16,   17,   18,   19,   18,   20,
-       21,   18,   22,   23,   18,   18,   24,   25,   18,   26,
-       18,   18,   27,   18,    4,   28,   29,   18,   30,   31,
-       18,   32,   33,   18,   18,   34,   35,   18,   36,   18,
-       18,   37,   18,   43,   44,   56,   57,   66,   67,   40,
-       40,   46,  111,  111,  110,  109,  107,  108,  107,  106,
-      103,  105,  101,  104,  103,  102,  101,  100,   95,   99,
-       98,   92,   91,   97,   89,   88,   96,   95,   94,   93,
-       92,   91,   90,   89,   88,   87,   86,   85,   84,   83,
-
-       82,   81,   80,   79,   78,   68,   77,   76,   75,   74,
-       73,   72,   71,   70,   69,   68,   42,   41,   38,   65,
-       64,   53,   63,   62,   61,   60,   59,   58,   55,   54,
-       53,   52,   51,   50,   49,   48,   47,   45,   42,   42,
-       41,   39,   38,  112,    3,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112
-
+      306,    4,    5,    6,    7,    8,    9,   10,   11,   12,
+       13,   14,   15,   16,   17,   18,   19,   20,   21,   22,
+       23,   24,   25,   26,   27,   28,   27,   29,   27,   27,
+       30,   31,   32,   33,   34,   27,   35,   36,   37,   27,
+       27,    4,   38,   39,   40,   41,   42,   43,   44,   27,
+       45,   46,   27,   27,   47,   48,   49,   50,   51,   27,
+       52,   53,   54,   27,   27,   55,   56,   57,   57,   57,
+       57,   58,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
+       57,   59,   60,   61,   62,   63,   63,   63,   73,   63,
+       72,   74,   63,   63,   63,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   64,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   63,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   63,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   63,   63,   63,   63,   63,   63,
+       63,   66,   69,   63,   67,   63,   70,   68,   75,   79,
+
+       63,   65,   77,   76,   80,   71,   78,   81,   82,   84,
+       85,   86,   87,   88,   89,   95,   90,   96,   97,   91,
+       93,   83,   92,   98,   94,   99,  101,  103,  104,  100,
+      102,  105,  106,  108,  109,  110,  111,  112,  113,  114,
+      115,  116,  117,  118,  107,  120,  121,  122,  123,  124,
+      125,  126,  127,  128,  129,  130,  132,  133,  119,  134,
+      135,  136,  137,  131,  138,  139,  140,  141,  142,  143,
+      145,  146,  147,  148,  149,  150,  151,  152,  153,  154,
+      155,  157,  158,  144,  159,  160,  161,  162,  156,  163,
+      164,  165,  166,  167,  168,  169,  170,  171,  172,  173,
+
+      174,  175,  176,  177,  178,  179,  180,  181,  182,  183,
+      184,  185,  186,  187,  188,  189,  190,  191,  192,  193,
+      194,  195,  196,  197,  198,  199,  200,  201,  202,  203,
+      204,  205,  206,  207,  208,  209,  210,  211,  212,  213,
+      214,  215,  216,  217,  218,  219,  220,  221,  222,  223,
+      224,  225,  226,  227,  228,  229,  230,  231,  232,  233,
+      234,  235,  236,  237,  238,  239,  240,  241,  242,  243,
+      244,  245,  246,  247,  248,  249,  250,  251,  252,  253,
+      254,  255,  256,  257,  258,  259,  260,  261,  262,  263,
+      264,  265,  266,  267,  268,  269,  270,  271,  272,  273,
+
+      274,  275,  276,  277,  278,  279,  280,  281,  282,  283,
+      284,  285,  286,  287,  288,  289,  290,  291,  292,  293,
+      294,  295,  296,  297,  298,  299,  300,  301,  302,  303,
+      304,  305,    3,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306
     } ;
 
-static yyconst flex_int16_t yy_chk[199] =
+static yyconst flex_int16_t yy_chk[498] =
     {   0,
+        3,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,   14,   14,   27,   27,   37,   37,  113,
-      113,  114,  110,  109,  108,  106,  105,  104,  102,  100,
-       99,   98,   97,   96,   94,   93,   90,   87,   86,   85,
-       84,   83,   82,   81,   80,   79,   78,   77,   76,   75,
-       74,   73,   72,   71,   70,   69,   67,   66,   65,   64,
-
-       63,   62,   61,   60,   59,   58,   57,   56,   55,   54,
-       52,   51,   50,   49,   48,   47,   42,   40,   38,   36,
-       35,   34,   33,   32,   31,   30,   29,   28,   26,   25,
-       24,   23,   22,   21,   20,   19,   17,   16,   12,   11,
-        8,    7,    5,    3,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112
-
+        1,    1,    1,    1,    1,    5,    7,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,   13,   17,   17,   19,   20,   25,   20,   26,   27,
+       25,   28,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       21,   22,   23,   22,   22,   24,   23,   22,   29,   31,
+
+       23,   21,   30,   29,   32,   24,   30,   33,   34,   35,
+       36,   37,   37,   38,   39,   42,   40,   43,   44,   40,
+       41,   34,   40,   45,   41,   46,   47,   48,   49,   46,
+       47,   50,   51,   52,   53,   54,   54,   64,   66,   67,
+       67,   68,   69,   70,   51,   71,   72,   73,   74,   75,
+       76,   78,   79,   80,   81,   82,   83,   84,   70,   85,
+       86,   87,   88,   82,   90,   91,   91,   92,   93,   94,
+       95,   96,   97,   98,   99,  100,  102,  103,  104,  105,
+      106,  107,  108,   94,  109,  110,  111,  113,  106,  114,
+      115,  116,  117,  118,  119,  120,  121,  122,  123,  124,
+
+      125,  126,  127,  128,  129,  130,  132,  133,  134,  135,
+      136,  138,  139,  140,  141,  142,  143,  144,  145,  146,
+      147,  148,  149,  150,  151,  152,  153,  154,  155,  157,
+      158,  159,  160,  161,  162,  163,  164,  165,  166,  167,
+      168,  171,  172,  173,  175,  176,  178,  179,  180,  181,
+      182,  183,  185,  186,  187,  188,  189,  190,  191,  194,
+      195,  196,  198,  199,  201,  202,  203,  204,  205,  206,
+      208,  209,  210,  211,  212,  213,  214,  219,  221,  222,
+      223,  224,  226,  227,  228,  229,  230,  231,  232,  237,
+      239,  240,  241,  242,  244,  245,  246,  249,  250,  251,
+
+      253,  256,  257,  258,  261,  262,  263,  265,  268,  269,
+      270,  271,  272,  273,  275,  276,  277,  278,  279,  280,
+      282,  284,  285,  287,  288,  290,  291,  293,  295,  296,
+      299,  300,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306,  306,  306,  306,
+      306,  306,  306,  306,  306,  306,  306
     } ;
-
 static yy_state_type yy_last_accepting_state;
 static char *yy_last_accepting_cpos;
 
@@ -546,7 +674,7 @@ char* strlower(char* s)
         }
 	return s;
 }
-#line 550 "lex.sql.c"
+#line 678 "lex.sql.c"
 
 #define INITIAL 0
 
@@ -702,7 +830,7 @@ YY_DECL
 #line 17 "SqlParser.l"
 
 
-#line 706 "lex.sql.c"
+#line 834 "lex.sql.c"
 
 	if ( !(yy_init) )
 		{
@@ -755,13 +883,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 113 )
+				if ( yy_current_state >= 307 )
 					yy_c = yy_meta[(unsigned int) yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 145 );
+		while ( yy_base[yy_current_state] != 433 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -818,106 +946,211 @@ return INDEX;
 case 7:
 YY_RULE_SETUP
 #line 25 "SqlParser.l"
-return QUIT;
+return CREATE;
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
 #line 26 "SqlParser.l"
-return QUIT;
+return ON;
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
 #line 27 "SqlParser.l"
-return COUNT;
+return COLUMNAR;
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 29 "SqlParser.l"
-return AND;
+#line 28 "SqlParser.l"
+return DICTIONARY;
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 30 "SqlParser.l"
-return OR;
+#line 29 "SqlParser.l"
+return COMPRESSED;
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 31 "SqlParser.l"
-return EQUAL;
+#line 30 "SqlParser.l"
+return CLUSTERED;
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 32 "SqlParser.l"
-return NEQUAL;
+#line 31 "SqlParser.l"
+return CLUSTER;
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 33 "SqlParser.l"
-return GREATER;
+#line 32 "SqlParser.l"
+return SSTABLE;
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 34 "SqlParser.l"
-return LESS;
+#line 33 "SqlParser.l"
+return VACUUM;
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 35 "SqlParser.l"
-return GREATEREQUAL;
+#line 34 "SqlParser.l"
+return UPDATE;
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 36 "SqlParser.l"
-return LESSEQUAL;
+#line 35 "SqlParser.l"
+return SET;
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 38 "SqlParser.l"
-sqllval.string = strdup(sqltext); return INTEGER;
+#line 36 "SqlParser.l"
+return DELETE;
 	YY_BREAK
 case 19:
-/* rule 19 can match eol */
 YY_RULE_SETUP
-#line 39 "SqlParser.l"
-sqllval.string = strdup(sqltext+1); sqllval.string[sqlleng-2] = 0; return STRING;
+#line 37 "SqlParser.l"
+return PARTITION;
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 40 "SqlParser.l"
-sqllval.string = strlower(strdup(sqltext)); return ID;
+#line 38 "SqlParser.l"
+return BY;
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 41 "SqlParser.l"
-return COMMA;
+#line 39 "SqlParser.l"
+return RANGE;
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 42 "SqlParser.l"
-return STAR;
+#line 40 "SqlParser.l"
+return QUIT;
 	YY_BREAK
 case 23:
-/* rule 23 can match eol */
 YY_RULE_SETUP
-#line 43 "SqlParser.l"
-return LF;
+#line 41 "SqlParser.l"
+return QUIT;
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 44 "SqlParser.l"
-/* ignore semicolon */
+#line 42 "SqlParser.l"
+return DISTINCT;
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 45 "SqlParser.l"
-/* ignore white space */
+#line 43 "SqlParser.l"
+return GROUP;
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
+#line 44 "SqlParser.l"
+return ORDER;
+	YY_BREAK
+case 27:
+YY_RULE_SETUP
+#line 45 "SqlParser.l"
+return LIMIT;
+	YY_BREAK
+case 28:
+YY_RULE_SETUP
 #line 47 "SqlParser.l"
+return AND;
+	YY_BREAK
+case 29:
+YY_RULE_SETUP
+#line 48 "SqlParser.l"
+return OR;
+	YY_BREAK
+case 30:
+YY_RULE_SETUP
+#line 49 "SqlParser.l"
+return EQUAL;
+	YY_BREAK
+case 31:
+YY_RULE_SETUP
+#line 50 "SqlParser.l"
+return NEQUAL;
+	YY_BREAK
+case 32:
+YY_RULE_SETUP
+#line 51 "SqlParser.l"
+return GREATER;
+	YY_BREAK
+case 33:
+YY_RULE_SETUP
+#line 52 "SqlParser.l"
+return LESS;
+	YY_BREAK
+case 34:
+YY_RULE_SETUP
+#line 53 "SqlParser.l"
+return GREATEREQUAL;
+	YY_BREAK
+case 35:
+YY_RULE_SETUP
+#line 54 "SqlParser.l"
+return LESSEQUAL;
+	YY_BREAK
+case 36:
+YY_RULE_SETUP
+#line 56 "SqlParser.l"
+sqllval.string = strdup(sqltext); return INTEGER;
+	YY_BREAK
+case 37:
+/* rule 37 can match eol */
+YY_RULE_SETUP
+#line 57 "SqlParser.l"
+sqllval.string = strdup(sqltext+1); sqllval.string[sqlleng-2] = 0; return STRING;
+	YY_BREAK
+case 38:
+YY_RULE_SETUP
+#line 58 "SqlParser.l"
+sqllval.string = strlower(strdup(sqltext)); return ID;
+	YY_BREAK
+case 39:
+YY_RULE_SETUP
+#line 59 "SqlParser.l"
+return COMMA;
+	YY_BREAK
+case 40:
+YY_RULE_SETUP
+#line 60 "SqlParser.l"
+return LPAREN;
+	YY_BREAK
+case 41:
+YY_RULE_SETUP
+#line 61 "SqlParser.l"
+return RPAREN;
+	YY_BREAK
+case 42:
+YY_RULE_SETUP
+#line 62 "SqlParser.l"
+return STAR;
+	YY_BREAK
+case 43:
+YY_RULE_SETUP
+#line 63 "SqlParser.l"
+return SLASH;
+	YY_BREAK
+case 44:
+/* rule 44 can match eol */
+YY_RULE_SETUP
+#line 64 "SqlParser.l"
+return LF;
+	YY_BREAK
+case 45:
+YY_RULE_SETUP
+#line 65 "SqlParser.l"
+/* ignore semicolon */
+	YY_BREAK
+case 46:
+YY_RULE_SETUP
+#line 66 "SqlParser.l"
+/* ignore white space */
+	YY_BREAK
+case 47:
+YY_RULE_SETUP
+#line 68 "SqlParser.l"
 ECHO;
 	YY_BREAK
-#line 921 "lex.sql.c"
+#line 1154 "lex.sql.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -1201,7 +1434,7 @@ static int yy_get_next_buffer (void)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 113 )
+			if ( yy_current_state >= 307 )
 				yy_c = yy_meta[(unsigned int) yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
@@ -1229,11 +1462,11 @@ static int yy_get_next_buffer (void)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 113 )
+		if ( yy_current_state >= 307 )
 			yy_c = yy_meta[(unsigned int) yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-	yy_is_jam = (yy_current_state == 112);
+	yy_is_jam = (yy_current_state == 306);
 
 	return yy_is_jam ? 0 : yy_current_state;
 }
@@ -1903,7 +2136,7 @@ void sqlfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 47 "SqlParser.l"
+#line 68 "SqlParser.l"
 
 
 
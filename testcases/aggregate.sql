@@ -0,0 +1,17 @@
+LOAD aggt FROM 'large.del' WITH INDEX
+SELECT SUM(key) FROM aggt
+SELECT AVG(key) FROM aggt
+SELECT MIN(key) FROM aggt
+SELECT MAX(key) FROM aggt
+SELECT COUNT(DISTINCT value) FROM aggt
+SELECT SUM(key) FROM aggt WHERE key > 2000 AND key < 2100
+SELECT MIN(key) FROM aggt WHERE value > 'T'
+SELECT MAX(key) FROM aggt WHERE key < 1000
+SELECT AVG(key) FROM aggt WHERE key > 5000
+
+LOAD aggn FROM 'negative.del'
+SELECT SUM(key) FROM aggn
+SELECT AVG(key) FROM aggn WHERE key < 0
+SELECT MIN(key) FROM aggn
+SELECT MAX(key) FROM aggn WHERE key < -10
+SELECT COUNT(DISTINCT key) FROM aggn
@@ -0,0 +1,10 @@
+LOAD negc FROM 'negative.del' COLUMNAR WITH INDEX
+SELECT COUNT(*) FROM negc
+SELECT * FROM negc WHERE key < -297
+SELECT * FROM negc WHERE key >= -2 AND key <= 2
+SELECT COUNT(*) FROM negc WHERE key < 0
+SELECT key FROM negc WHERE value = 'n-150'
+
+LOAD negd FROM 'negative.del' COLUMNAR
+SELECT COUNT(*) FROM negd WHERE key < 0
+SELECT * FROM negd WHERE key > -300 AND key < -296
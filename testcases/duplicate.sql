@@ -0,0 +1,11 @@
+LOAD dupr FROM 'duplicate.del'
+CREATE INDEX ON dupr
+SELECT COUNT(*) FROM dupr WHERE key = 100
+SELECT COUNT(*) FROM dupr WHERE key >= 100
+SELECT COUNT(*) FROM dupr WHERE key > 99 AND key < 101
+SELECT COUNT(*) FROM dupr WHERE key = 100 AND value = 'k100-0'
+SELECT key FROM dupr WHERE key >= 100 LIMIT 3
+
+LOAD dupc FROM 'duplicate.del' CLUSTERED WITH INDEX
+SELECT SUM(key) FROM dupc
+SELECT COUNT(*) FROM dupc WHERE key = 100
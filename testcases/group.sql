@@ -0,0 +1,6 @@
+LOAD groupt FROM 'xlarge.del'
+LOAD groupt FROM 'negative.del'
+SELECT COUNT(*) FROM groupt
+SELECT key, count(*) FROM groupt GROUP BY key
+SELECT key, sum(key) FROM groupt WHERE key > -3 AND key < 40 GROUP BY key
+SELECT value, count(*) FROM groupt WHERE key < 30 GROUP BY value
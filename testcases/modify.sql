@@ -0,0 +1,31 @@
+LOAD modt FROM 'large.del' WITH INDEX
+DELETE FROM modt WHERE key >= 2000 AND key < 3200
+DELETE FROM modt WHERE key >= 4000
+SELECT COUNT(*) FROM modt
+SELECT * FROM modt WHERE key > 1980 AND key < 3220
+SELECT key FROM modt WHERE key > 1980 AND key < 3220
+SELECT COUNT(*) FROM modt WHERE key >= 2000 AND key < 3200
+SELECT * FROM modt WHERE key >= 3980
+SELECT key FROM modt WHERE key >= 3980
+SELECT MAX(key) FROM modt
+SELECT * FROM modt ORDER BY key DESC LIMIT 3
+
+UPDATE modt SET value = 'Ed, a value long enough not to fit in the place of the old one' WHERE key = 1213
+UPDATE modt SET value = 'a value of every tuple whose key is under one hundred' WHERE key < 100
+UPDATE modt SET value = 'aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa' WHERE key = 12
+SELECT * FROM modt WHERE key = 1213
+SELECT * FROM modt WHERE key < 100
+SELECT COUNT(*) FROM modt
+SELECT COUNT(*) FROM modt WHERE value = 'a value of every tuple whose key is under one hundred'
+SELECT key FROM modt WHERE value = 'aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa'
+DELETE FROM modt WHERE key < 50
+SELECT COUNT(*) FROM modt WHERE value = 'a value of every tuple whose key is under one hundred'
+SELECT COUNT(*) FROM modt
+
+LOAD dupd FROM 'duplicate.del' WITH INDEX
+UPDATE dupd SET value = 'a value that does not fit in the place of the old one' WHERE key = 100
+SELECT COUNT(*) FROM dupd WHERE value = 'a value that does not fit in the place of the old one'
+SELECT COUNT(*) FROM dupd WHERE key = 100
+DELETE FROM dupd WHERE key = 100
+SELECT COUNT(*) FROM dupd
+SELECT COUNT(*) FROM dupd WHERE key >= 50 AND key <= 101
@@ -0,0 +1,7 @@
+LOAD ordert FROM 'xlarge.del'
+LOAD ordert FROM 'xlarge.del'
+SELECT COUNT(*) FROM ordert
+SELECT key FROM ordert ORDER BY value LIMIT 7500
+SELECT * FROM ordert ORDER BY value DESC LIMIT 5
+SELECT * FROM ordert ORDER BY key DESC LIMIT 5
+SELECT * FROM ordert WHERE key < 1000 ORDER BY key LIMIT 5
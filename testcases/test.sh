@@ -8,3 +8,22 @@ rm -f xlarge.tbl xlarge.idx
 
 ./bruinbase < test.sql
 
+# the other scripts print nothing unless their output differs from the expected one
+rm -f negc.* negd.*
+./bruinbase < column.sql 2> /dev/null | diff column_output.txt -
+
+rm -f modt.* dupd.*
+./bruinbase < modify.sql 2> /dev/null | diff modify_output.txt -
+
+rm -f aggt.* aggn.*
+./bruinbase < aggregate.sql 2> /dev/null | diff aggregate_output.txt -
+
+# the groups come in no particular order, so the lines are compared sorted
+rm -f groupt.*
+./bruinbase < group.sql 2> /dev/null | LC_ALL=C sort | diff group_output.txt -
+
+rm -f ordert.*
+./bruinbase < order.sql 2> /dev/null | diff order_output.txt -
+
+rm -f dupr.* dupc.*
+./bruinbase < duplicate.sql 2> /dev/null | diff duplicate_output.txt -